@@ -0,0 +1,264 @@
+// Engine benchmarks, built and run by "make benchmark". Not part of the
+// game binary.
+//
+// Microbenchmarks time single engine calls against a fixed mid-game
+// position; macrobenchmarks play whole bot games from fixed seeds.
+// Results go to the console and, as JSON, to the file named on the
+// command line (benchmark.json by default).
+
+#include "monopoly.h"
+#include "board.h"
+#include "simulation.h"
+#include "savefile.h"
+#include "undo.h"
+#include <chrono>
+
+using namespace std::chrono;
+
+const unsigned long long BENCHMARK_SEED = 20240601;
+const int FIXTURE_TURNS = 200;
+const int BENCHMARK_REPEATS = 5;
+const int MICRO_ITERATIONS = 1000000;
+const int MACRO_GAMES = 2000;
+const int MAX_RESULTS = 16;
+
+struct MicroResult {
+    const char* name;
+    long long iterations;
+    double nsPerOp; // best of BENCHMARK_REPEATS
+};
+
+struct MacroResult {
+    const char* name;
+    int games;
+    long long turns;
+    double seconds;
+};
+
+// Results are folded into this so the optimizer can't drop the work
+static volatile long long benchmarkSink;
+
+static MicroResult microResults[MAX_RESULTS];
+static int numMicroResults = 0;
+
+static double elapsedSeconds(steady_clock::time_point start) {
+    return duration<double>(steady_clock::now() - start).count();
+}
+
+// Runs body(iterations) BENCHMARK_REPEATS times and records the best time
+template <typename Body>
+static void runMicro(const char* name, long long iterations, Body body) {
+    double best = 0.0;
+    for (int repeat = 0; repeat < BENCHMARK_REPEATS; repeat++) {
+        steady_clock::time_point start = steady_clock::now();
+        benchmarkSink += body(iterations);
+        double seconds = elapsedSeconds(start);
+        if (repeat == 0 || seconds < best) {
+            best = seconds;
+        }
+    }
+    
+    MicroResult* result = &microResults[numMicroResults++];
+    result->name = name;
+    result->iterations = iterations;
+    result->nsPerOp = best * 1e9 / iterations;
+    cout << left << setw(32) << name << right << setw(12) << fixed << setprecision(2)
+         << result->nsPerOp << " ns/op\n";
+}
+
+// A developed position: BASIC_BOT games from a fixed seed, stopped early
+static void makeFixture(GameState* game) {
+    setupHeadlessGame(game, activeBoard, MAX_PLAYERS, &BASIC_BOT, BENCHMARK_SEED);
+    for (int turn = 0; turn < FIXTURE_TURNS; turn++) {
+        playTurn(game, game->board->squares);
+    }
+}
+
+// Returns false if undoing a turn didn't give back the fixture, in which
+// case the undo timing means nothing
+static bool runMicrobenchmarks(const GameState* fixture) {
+    const Property* board = fixture->board->squares;
+    static GameState game;
+    game = *fixture;
+    
+    cout << "\n=== Microbenchmarks ===\n";
+    
+    runMicro("calculateRent", MICRO_ITERATIONS, [&](long long n) {
+        long long total = 0;
+        for (long long i = 0; i < n; i++) {
+            int square = i % game.board->size;
+            total += calculateRent(board[square], &game, 7, square);
+        }
+        return total;
+    });
+    
+    runMicro("hasMonopoly", MICRO_ITERATIONS, [&](long long n) {
+        long long total = 0;
+        for (long long i = 0; i < n; i++) {
+            total += hasMonopoly(&game, board, i % game.numPlayers, i % game.board->size);
+        }
+        return total;
+    });
+    
+    runMicro("rollDice", MICRO_ITERATIONS, [&](long long n) {
+        long long total = 0;
+        for (long long i = 0; i < n; i++) {
+            int dice1, dice2;
+            rollDice(&game, &dice1, &dice2);
+            total += dice1 + dice2;
+        }
+        return total;
+    });
+    
+    runMicro("canBuildHouse", MICRO_ITERATIONS, [&](long long n) {
+        long long total = 0;
+        for (long long i = 0; i < n; i++) {
+            game.currentPlayer = i % game.numPlayers;
+            total += canBuildHouse(&game, board, i % game.board->size);
+        }
+        return total;
+    });
+    
+    // Each iteration restores the fixture, so this includes one GameState copy
+    runMicro("handleBankruptcy", MICRO_ITERATIONS / 10, [&](long long n) {
+        long long total = 0;
+        for (long long i = 0; i < n; i++) {
+            game = *fixture;
+            game.currentPlayer = i % game.numPlayers;
+            game.players[game.currentPlayer].money = -1000 - static_cast<int>(i % 4000);
+            handleBankruptcy(&game, board);
+            total += game.players[game.currentPlayer].bankrupt;
+        }
+        return total;
+    });
+    game = *fixture;
+    
+    // saveGame and loadGame are these plus one file write or read
+    unsigned char buffer[MAX_SAVE_SIZE];
+    int length = encodeGame(&game, buffer, MAX_SAVE_SIZE);
+    
+    runMicro("saveGame (encode)", MICRO_ITERATIONS / 10, [&](long long n) {
+        long long total = 0;
+        for (long long i = 0; i < n; i++) {
+            total += encodeGame(&game, buffer, MAX_SAVE_SIZE);
+        }
+        return total;
+    });
+    
+    runMicro("loadGame (decode)", MICRO_ITERATIONS / 10, [&](long long n) {
+        static GameState loaded;
+        loaded.board = activeBoard;
+        PlayerNames names;
+        long long total = 0;
+        for (long long i = 0; i < n; i++) {
+            total += decodeGame(buffer, length, &loaded, &names);
+        }
+        return total;
+    });
+    
+    // Exploring one turn from the fixture and going back, by copying the
+    // state or by undoing the turn's changes
+    runMicro("playTurn + copy back", MICRO_ITERATIONS / 10, [&](long long n) {
+        long long total = 0;
+        for (long long i = 0; i < n; i++) {
+            game = *fixture;
+            playTurn(&game, board);
+            total += game.players[0].money;
+        }
+        return total;
+    });
+    game = *fixture;
+    
+    static UndoLog log;
+    attachUndoLog(&game, &log);
+    UndoMark mark = markUndo(&game);
+    
+    // The undone state must save exactly as the fixture does
+    unsigned char undone[MAX_SAVE_SIZE];
+    playTurn(&game, board);
+    bool undoOk = undoTo(&game, board, &mark) &&
+                  encodeGame(&game, undone, MAX_SAVE_SIZE) == length && memcmp(undone, buffer, length) == 0;
+    if (!undoOk) {
+        cout << "playTurn + undoTo: undoing a turn didn't restore the fixture\n";
+        detachUndoLog(&game);
+        return false;
+    }
+    
+    runMicro("playTurn + undoTo", MICRO_ITERATIONS / 10, [&](long long n) {
+        long long total = 0;
+        for (long long i = 0; i < n && undoOk; i++) {
+            playTurn(&game, board);
+            total += game.players[0].money;
+            undoOk = undoTo(&game, board, &mark);
+        }
+        return total;
+    });
+    detachUndoLog(&game);
+    if (!undoOk) {
+        cout << "playTurn + undoTo: the undo log overflowed\n";
+    }
+    return undoOk;
+}
+
+// Whole games, one thread, seeds BENCHMARK_SEED + 0..games-1
+static MacroResult runGames(const char* name, int numPlayers, int games) {
+    static GameState game;
+    MacroResult result = {name, games, 0, 0.0};
+    
+    steady_clock::time_point start = steady_clock::now();
+    for (int i = 0; i < games; i++) {
+        setupHeadlessGame(&game, activeBoard, numPlayers, &BASIC_BOT, BENCHMARK_SEED + i);
+        result.turns += playGame(&game, game.board->squares, DEFAULT_TURN_LIMIT).turns;
+    }
+    result.seconds = elapsedSeconds(start);
+    
+    cout << left << setw(32) << name << right << fixed << setprecision(0)
+         << setw(12) << result.games / result.seconds << " games/s"
+         << setw(12) << result.turns / result.seconds << " turns/s\n";
+    return result;
+}
+
+static bool writeJson(const char* filename, const MacroResult macro[], int numMacro) {
+    ofstream outFile(filename);
+    if (!outFile) {
+        cout << "Error opening " << filename << "!\n";
+        return false;
+    }
+    
+    outFile << "{\n  \"seed\": " << BENCHMARK_SEED << ",\n  \"micro\": [\n" << fixed << setprecision(3);
+    for (int i = 0; i < numMicroResults; i++) {
+        outFile << "    {\"name\": \"" << microResults[i].name << "\", \"iterations\": "
+                << microResults[i].iterations << ", \"ns_per_op\": " << microResults[i].nsPerOp
+                << "}" << (i + 1 < numMicroResults ? "," : "") << "\n";
+    }
+    outFile << "  ],\n  \"macro\": [\n";
+    for (int i = 0; i < numMacro; i++) {
+        outFile << "    {\"name\": \"" << macro[i].name << "\", \"games\": " << macro[i].games
+                << ", \"turns\": " << macro[i].turns << ", \"seconds\": " << macro[i].seconds
+                << ", \"games_per_sec\": " << macro[i].games / macro[i].seconds
+                << ", \"turns_per_sec\": " << macro[i].turns / macro[i].seconds
+                << "}" << (i + 1 < numMacro ? "," : "") << "\n";
+    }
+    outFile << "  ]\n}\n";
+    
+    outFile.close();
+    cout << "\nResults written to " << filename << "\n";
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    const char* output = (argc > 1) ? argv[1] : "benchmark.json";
+    
+    static GameState fixture;
+    makeFixture(&fixture);
+    if (!runMicrobenchmarks(&fixture)) {
+        return 1;
+    }
+    
+    cout << "\n=== Macrobenchmarks ===\n";
+    MacroResult macro[2];
+    macro[0] = runGames("basic_bot_2p", 2, MACRO_GAMES);
+    macro[1] = runGames("basic_bot_4p", MAX_PLAYERS, MACRO_GAMES);
+    
+    return writeJson(output, macro, 2) ? 0 : 1;
+}
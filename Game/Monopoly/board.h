@@ -0,0 +1,216 @@
+#ifndef BOARD_H
+#define BOARD_H
+
+#include "monopoly.h"
+
+// Board definition. Everything below is evaluated by the compiler: games
+// share STANDARD_BOARD, and initializeBoard only copies INITIAL_SQUARES.
+// Boards loaded from a file (see boardfile.h) go through the same makeBoard.
+struct SquareDefinition {
+    const char* name;
+    int type;
+    int color;
+    int price;   // tax squares: the tax
+    int rent[6]; // bare, with 1-4 houses and with a hotel; all 0 for the usual schedule
+    int houseCost; // 0 for half the price
+};
+
+const int STANDARD_BOARD_SIZE = 40;
+const int STANDARD_JAIL_SQUARE = 10;
+const int STANDARD_GO_TO_JAIL_SQUARE = 30;
+
+constexpr SquareDefinition STANDARD_SQUARES[STANDARD_BOARD_SIZE] = {
+    {"GO",                    0, -1,   0},
+    {"Mediterranean Avenue",  1,  0,  60},
+    {"Community Chest",       5, -1,   0},
+    {"Baltic Avenue",         1,  0,  60},
+    {"Income Tax",            6, -1, 200},
+    {"Reading Railroad",      2, -1, 200},
+    {"Oriental Avenue",       1,  1, 100},
+    {"Chance",                4, -1,   0},
+    {"Vermont Avenue",        1,  1, 100},
+    {"Connecticut Avenue",    1,  1, 120},
+    {"Jail",                  0, -1,   0},
+    {"St. Charles Place",     1,  2, 140},
+    {"Electric Company",      3, -1, 150},
+    {"States Avenue",         1,  2, 140},
+    {"Virginia Avenue",       1,  2, 160},
+    {"Pennsylvania Railroad", 2, -1, 200},
+    {"St. James Place",       1,  3, 180},
+    {"Community Chest",       5, -1,   0},
+    {"Tennessee Avenue",      1,  3, 180},
+    {"New York Avenue",       1,  3, 200},
+    {"Free Parking",          0, -1,   0},
+    {"Kentucky Avenue",       1,  4, 220},
+    {"Chance",                4, -1,   0},
+    {"Indiana Avenue",        1,  4, 220},
+    {"Illinois Avenue",       1,  4, 240},
+    {"B. & O. Railroad",      2, -1, 200},
+    {"Atlantic Avenue",       1,  5, 260},
+    {"Ventnor Avenue",        1,  5, 260},
+    {"Water Works",           3, -1, 150},
+    {"Marvin Gardens",        1,  5, 280},
+    {"Go to Jail",            0, -1,   0},
+    {"Pacific Avenue",        1,  6, 300},
+    {"North Carolina Avenue", 1,  6, 300},
+    {"Community Chest",       5, -1,   0},
+    {"Pennsylvania Avenue",   1,  6, 320},
+    {"Short Line",            2, -1, 200},
+    {"Chance",                4, -1,   0},
+    {"Park Place",            1,  7, 350},
+    {"Luxury Tax",            6, -1, 100},
+    {"Boardwalk",             1,  7, 400}
+};
+
+// Advance-to cards name squares of this board; loadBoard finds their
+// counterparts on other boards
+constexpr Card STANDARD_DECKS[NUM_DECKS][DECK_SIZE] = {
+    { // Chance
+        {"Advance to GO (Collect $200)", CARD_MOVE_TO, 0, 0},
+        {"Advance to Illinois Avenue", CARD_MOVE_TO, 24, 0},
+        {"Advance to St. Charles Place", CARD_MOVE_TO, 11, 0},
+        {"Take a walk on the Boardwalk", CARD_MOVE_TO, 39, 0},
+        {"Take a trip to Reading Railroad", CARD_MOVE_TO, 5, 0},
+        {"Advance to the nearest Railroad. Pay the owner twice the rent", CARD_NEAREST_RAILROAD, 0, 0},
+        {"Advance to the nearest Railroad. Pay the owner twice the rent", CARD_NEAREST_RAILROAD, 0, 0},
+        {"Advance to the nearest Utility. Pay the owner ten times the roll", CARD_NEAREST_UTILITY, 0, 0},
+        {"Go back 3 spaces", CARD_MOVE_BY, -3, 0},
+        {"Go to Jail", CARD_GO_TO_JAIL, 0, 0},
+        {"Get Out of Jail Free", CARD_JAIL_FREE, 0, 0},
+        {"Bank pays you dividend of $50", CARD_MONEY, 50, 0},
+        {"Your building loan matures - Collect $150", CARD_MONEY, 150, 0},
+        {"Pay poor tax of $15", CARD_MONEY, -15, 0},
+        {"Make general repairs - $25 per house, $100 per hotel", CARD_REPAIRS, -25, -100},
+        {"Elected Chairman of the Board - Pay each player $50", CARD_EACH_PLAYER, -50, 0}
+    },
+    { // Community Chest
+        {"Advance to GO (Collect $200)", CARD_MOVE_TO, 0, 0},
+        {"Go to Jail", CARD_GO_TO_JAIL, 0, 0},
+        {"Get Out of Jail Free", CARD_JAIL_FREE, 0, 0},
+        {"Bank error in your favor - Collect $200", CARD_MONEY, 200, 0},
+        {"Doctor's fees - Pay $50", CARD_MONEY, -50, 0},
+        {"From sale of stock you get $50", CARD_MONEY, 50, 0},
+        {"Holiday fund matures - Receive $100", CARD_MONEY, 100, 0},
+        {"Income tax refund - Collect $20", CARD_MONEY, 20, 0},
+        {"Life insurance matures - Collect $100", CARD_MONEY, 100, 0},
+        {"Pay hospital fees of $100", CARD_MONEY, -100, 0},
+        {"Pay school fees of $50", CARD_MONEY, -50, 0},
+        {"Receive $25 consultancy fee", CARD_MONEY, 25, 0},
+        {"Second prize in a beauty contest - Collect $10", CARD_MONEY, 10, 0},
+        {"You inherit $100", CARD_MONEY, 100, 0},
+        {"Street repairs - $40 per house, $115 per hotel", CARD_REPAIRS, -40, -115},
+        {"It is your birthday - Collect $10 from every player", CARD_EACH_PLAYER, 10, 0}
+    }
+};
+
+const int RAILROAD_BASE_RENT = 25;
+
+// Derives one square's rent, house and mortgage values from its definition
+constexpr Property makeProperty(const SquareDefinition& definition) {
+    Property property = {};
+    
+    for (int i = 0; i < MAX_NAME_LENGTH - 1 && definition.name[i] != '\0'; i++) {
+        property.name[i] = definition.name[i];
+    }
+    property.type = definition.type;
+    property.color = definition.color;
+    property.price = definition.price;
+    
+    if (property.type == 1 && definition.rent[0] != 0) { // Regular properties, own schedule
+        property.baseRent = definition.rent[0];
+        property.rentWithSet = property.baseRent * 2;
+        property.houseCost = definition.houseCost;
+        
+        for (int j = 0; j < 4; j++) {
+            property.rentWithHouses[j] = definition.rent[j + 1];
+        }
+        property.rentWithHotel = definition.rent[5];
+    } else if (property.type == 1) { // Regular properties
+        property.baseRent = property.price / 10;
+        property.rentWithSet = property.baseRent * 2;
+        property.houseCost = property.price / 2;
+        
+        for (int j = 0; j < 4; j++) {
+            property.rentWithHouses[j] = property.baseRent * (j + 3);
+        }
+        property.rentWithHotel = property.baseRent * 12;
+    } else if (property.type == 2) { // Railroads
+        property.baseRent = definition.rent[0] != 0 ? definition.rent[0] : RAILROAD_BASE_RENT;
+    }
+    
+    if (property.type >= 1 && property.type <= 3) { // Anything that can be owned
+        property.mortgageValue = property.price / 2;
+        property.unmortgageCost = static_cast<int>(property.mortgageValue * 1.1); // 10% interest
+    }
+    return property;
+}
+
+// FNV-1a, one int at a time
+constexpr unsigned int hashValue(unsigned int hash, int value) {
+    for (int i = 0; i < 4; i++) {
+        hash = (hash ^ ((static_cast<unsigned int>(value) >> (8 * i)) & 0xFF)) * 16777619u;
+    }
+    return hash;
+}
+
+// Builds the squares, the decks and the color group, railroad and utility masks
+constexpr Board makeBoard(const SquareDefinition definitions[], int size, int jailSquare, int goToJailSquare) {
+    Board board = {};
+    board.size = size;
+    board.jailSquare = jailSquare;
+    board.goToJailSquare = goToJailSquare;
+    board.startingMoney = STARTING_MONEY;
+    board.goSalary = GO_SALARY;
+    board.jailFine = GET_OUT_OF_JAIL_COST;
+    
+    unsigned int id = 2166136261u;
+    id = hashValue(hashValue(hashValue(id, size), jailSquare), goToJailSquare);
+    for (int i = 0; i < size; i++) {
+        board.squares[i] = makeProperty(definitions[i]);
+        
+        const Property& property = board.squares[i];
+        for (int j = 0; property.name[j] != '\0'; j++) {
+            id = hashValue(id, property.name[j]);
+        }
+        id = hashValue(hashValue(hashValue(id, property.type), property.color), property.price);
+        id = hashValue(hashValue(hashValue(id, property.baseRent), property.rentWithHotel), property.houseCost);
+        for (int j = 0; j < 4; j++) {
+            id = hashValue(id, property.rentWithHouses[j]);
+        }
+        
+        int color = property.color;
+        if (property.type == 1 && color >= 0) {
+            board.colorMasks[color] |= squareBit(i);
+        } else if (property.type == 2) {
+            board.railroadMask |= squareBit(i);
+        } else if (property.type == 3) {
+            board.utilityMask |= squareBit(i);
+        }
+    }
+    board.id = id;
+    
+    for (int deck = 0; deck < NUM_DECKS; deck++) {
+        for (int card = 0; card < DECK_SIZE; card++) {
+            board.cards[deck][card] = STANDARD_DECKS[deck][card];
+        }
+    }
+    return board;
+}
+
+struct SquareTable {
+    SquareState squares[MAX_BOARD_SIZE];
+};
+
+constexpr SquareTable makeInitialSquares() {
+    SquareTable table = {};
+    for (int i = 0; i < MAX_BOARD_SIZE; i++) {
+        table.squares[i].owner = -1;
+    }
+    return table;
+}
+
+inline constexpr Board STANDARD_BOARD = makeBoard(STANDARD_SQUARES, STANDARD_BOARD_SIZE,
+                                                  STANDARD_JAIL_SQUARE, STANDARD_GO_TO_JAIL_SQUARE);
+inline constexpr SquareTable INITIAL_SQUARES = makeInitialSquares();
+
+#endif
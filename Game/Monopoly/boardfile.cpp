@@ -0,0 +1,200 @@
+#include "boardfile.h"
+#include "board.h"
+#include <sstream>
+#include <vector>
+
+// Line keywords, their square types and how many numbers follow the name
+struct SquareKind {
+    const char* keyword;
+    int type;
+    int numbers;      // required
+    int extraNumbers; // optional, all or none
+};
+
+const SquareKind SQUARE_KINDS[] = {
+    {"go",       0, 0, 0},
+    {"property", 1, 2, 7},
+    {"railroad", 2, 1, 1},
+    {"utility",  3, 1, 0},
+    {"chance",   4, 0, 0},
+    {"chest",    5, 0, 0},
+    {"tax",      6, 1, 0},
+    {"jail",     0, 0, 0},
+    {"gotojail", 0, 0, 0},
+    {"free",     0, 0, 0}
+};
+const int NUM_SQUARE_KINDS = sizeof(SQUARE_KINDS) / sizeof(SQUARE_KINDS[0]);
+const int KIND_GO = 0;
+const int KIND_JAIL = 7;
+const int KIND_GO_TO_JAIL = 8;
+
+static bool boardError(const char* filename, int line, const string& message) {
+    cout << filename;
+    if (line > 0) {
+        cout << " line " << line;
+    }
+    cout << ": " << message << '\n';
+    return false;
+}
+
+static string trim(const string& text) {
+    size_t first = text.find_first_not_of(" \t\r");
+    if (first == string::npos) {
+        return "";
+    }
+    return text.substr(first, text.find_last_not_of(" \t\r") - first + 1);
+}
+
+static int findSquare(const Board* board, const char* name) {
+    for (int i = 0; i < board->size; i++) {
+        if (strcmp(board->squares[i].name, name) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Points advance-to cards at this board's counterparts of their squares
+static bool placeCards(const char* filename, Board* board) {
+    for (int deck = 0; deck < NUM_DECKS; deck++) {
+        for (int i = 0; i < DECK_SIZE; i++) {
+            Card* card = &board->cards[deck][i];
+            if (card->actionType != CARD_MOVE_TO) {
+                continue;
+            }
+            const Property& standard = STANDARD_BOARD.squares[card->actionValue];
+            int target = findSquare(board, standard.name);
+            if (target == -1 && card->actionValue < board->size &&
+                board->squares[card->actionValue].type == standard.type) {
+                target = card->actionValue;
+            }
+            if (target == -1) {
+                return boardError(filename, 0, string("no square for the card \"") + card->text + "\"");
+            }
+            card->actionValue = target;
+        }
+    }
+    return true;
+}
+
+// Reads and checks a board definition (see boardfile.h). board is only
+// written if the whole file is valid.
+bool loadBoard(const char* filename, Board* board) {
+    ifstream inFile(filename);
+    if (!inFile) {
+        return boardError(filename, 0, "cannot open the file");
+    }
+    
+    vector<string> names;
+    SquareDefinition definitions[MAX_BOARD_SIZE] = {};
+    int jailSquare = -1;
+    int goToJailSquare = -1;
+    int size = 0;
+    string text;
+    
+    for (int line = 1; getline(inFile, text); line++) {
+        text = trim(text);
+        if (text.empty() || text[0] == '#') {
+            continue;
+        }
+        
+        vector<string> fields;
+        stringstream stream(text);
+        string field;
+        while (getline(stream, field, ',')) {
+            fields.push_back(trim(field));
+        }
+        
+        int kind = 0;
+        while (kind < NUM_SQUARE_KINDS && fields[0] != SQUARE_KINDS[kind].keyword) {
+            kind++;
+        }
+        if (kind == NUM_SQUARE_KINDS) {
+            return boardError(filename, line, "unknown square kind \"" + fields[0] + "\"");
+        }
+        const SquareKind* squareKind = &SQUARE_KINDS[kind];
+        int numbers = static_cast<int>(fields.size()) - 2;
+        if (numbers != squareKind->numbers &&
+            (squareKind->extraNumbers == 0 || numbers != squareKind->numbers + squareKind->extraNumbers)) {
+            return boardError(filename, line, "wrong number of fields for " + fields[0]);
+        }
+        if (size == MAX_BOARD_SIZE) {
+            return boardError(filename, line, "more than " + to_string(MAX_BOARD_SIZE) + " squares");
+        }
+        if (fields[1].empty() || fields[1].length() >= static_cast<size_t>(MAX_NAME_LENGTH)) {
+            return boardError(filename, line, "names must be 1 to " + to_string(MAX_NAME_LENGTH - 1) + " characters");
+        }
+        
+        int values[9] = {0};
+        for (int i = 0; i < numbers; i++) {
+            char* end;
+            long value = strtol(fields[i + 2].c_str(), &end, 10);
+            if (fields[i + 2].empty() || *end != '\0' || value < 0 || value > MAX_BOARD_PRICE) {
+                return boardError(filename, line, "\"" + fields[i + 2] + "\" is not an amount from 0 to " +
+                                                  to_string(MAX_BOARD_PRICE));
+            }
+            values[i] = static_cast<int>(value);
+        }
+        
+        SquareDefinition* definition = &definitions[size];
+        definition->type = squareKind->type;
+        definition->color = -1;
+        if (squareKind->numbers > 0) {
+            definition->price = values[0];
+            if (values[0] == 0) {
+                return boardError(filename, line, "prices and taxes can't be 0");
+            }
+        }
+        if (kind == 1) { // property
+            definition->color = values[1];
+            if (values[1] >= NUM_COLORS) {
+                return boardError(filename, line, "colors go from 0 to " + to_string(NUM_COLORS - 1));
+            }
+            if (numbers > 2) {
+                for (int i = 0; i < 6; i++) {
+                    definition->rent[i] = values[i + 2];
+                }
+                definition->houseCost = values[8];
+                if (values[2] == 0 || values[8] == 0) {
+                    return boardError(filename, line, "rent and house cost can't be 0");
+                }
+            }
+        } else if (kind == 2 && numbers > 1) { // railroad with its own rent
+            definition->rent[0] = values[1];
+            if (values[1] == 0) {
+                return boardError(filename, line, "rent can't be 0");
+            }
+        }
+        
+        if ((kind == KIND_GO) != (size == 0)) {
+            return boardError(filename, line, "GO must be the first square, and only the first");
+        }
+        if (kind == KIND_JAIL || kind == KIND_GO_TO_JAIL) {
+            int* square = kind == KIND_JAIL ? &jailSquare : &goToJailSquare;
+            if (*square != -1) {
+                return boardError(filename, line, "only one " + fields[0] + " square is allowed");
+            }
+            *square = size;
+        }
+        names.push_back(fields[1]);
+        size++;
+    }
+    
+    if (size < MIN_BOARD_SIZE) {
+        return boardError(filename, 0, "a board needs at least " + to_string(MIN_BOARD_SIZE) + " squares");
+    }
+    if (jailSquare == -1 || goToJailSquare == -1) {
+        return boardError(filename, 0, "a board needs a jail and a gotojail square");
+    }
+    
+    // Names are only read while the board is built
+    for (int i = 0; i < size; i++) {
+        definitions[i].name = names[i].c_str();
+    }
+    Board loaded = makeBoard(definitions, size, jailSquare, goToJailSquare);
+    if (!placeCards(filename, &loaded)) {
+        return false;
+    }
+    *board = loaded;
+    return true;
+}
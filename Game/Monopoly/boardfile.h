@@ -0,0 +1,30 @@
+#ifndef BOARDFILE_H
+#define BOARDFILE_H
+
+#include "monopoly.h"
+
+// Board definition files describe one square per line, starting from GO,
+// as comma-separated fields. Blank lines and lines starting with # are
+// skipped.
+//   go, <name>
+//   property, <name>, <price>, <color 0-7>[, <rent>, <1 house>, <2 houses>,
+//             <3 houses>, <4 houses>, <hotel>, <house cost>]
+//   railroad, <name>, <price>[, <rent when only one is owned>]
+//   utility, <name>, <price>
+//   chance, <name>
+//   chest, <name>
+//   tax, <name>, <amount>
+//   jail, <name>
+//   gotojail, <name>
+//   free, <name>       (nothing happens, like Free Parking)
+// Properties without a rent schedule get the standard one (see board.h).
+// An advance-to card goes to the square with the name it has on the
+// standard board or, failing that, to the square in the same place if it
+// is of the same kind. standard_board.csv is the standard board.
+const int MIN_BOARD_SIZE = 13; // more squares than any roll
+const int MAX_BOARD_PRICE = 100000;
+
+// Function declarations
+bool loadBoard(const char*, Board*);
+
+#endif
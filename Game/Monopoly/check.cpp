@@ -0,0 +1,1027 @@
+// Engine self-checks, built and run by "make check". Not part of the
+// game binary.
+//
+// Each check puts the engine against a slower version of the same thing
+// that is plainly right, on positions from bot games with fixed seeds:
+//   ownership    the ownership masks and holdings lists, kept up to date
+//                by every change, are what rebuilding them gives after
+//                every turn and every trade, sale and mortgage
+//   undo         undoTo gives back exactly the state the mark was made in
+//   save         a save decodes to the game it was made from, and every
+//                short, overlong or corrupted save is rejected untouched
+//   liquidation  planLiquidation loses no more than an exhaustive search
+//                over sale and mortgage sequences finds is needed
+//   dice         findDiceStream in any order gives the stream reached by
+//                jumping straight from stream 0, streams don't share
+//                draws, and a tournament comes out the same on any number
+//                of threads
+//   cards        shuffled decks are permutations that deal every card
+//                in every slot, draws go round the deck, and every card
+//                does what a plain reading of it says, with any player it
+//                leaves in debt settled at once
+//   landing      the landing probabilities sum to 1 and match where
+//                players of seeded games end their rolls, for both jail
+//                strategies
+//   server       a client that pipelines commands and closes still has
+//                every command run (the server runs in a child process)
+// One line per check; the exit status is 1 if any of them fails.
+
+#include "monopoly.h"
+#include "simulation.h"
+#include "savefile.h"
+#include "undo.h"
+#include "turn.h"
+#include "liquidation.h"
+#include "tournament.h"
+#include "server.h"
+#include "markov.h"
+#include <map>
+#include <set>
+#include <csignal>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+
+const unsigned long long CHECK_SEED = 20240601;
+const int CHECK_OWNERSHIP_GAMES = 200;
+const int CHECK_OWNERSHIP_TURNS = 400;
+const int CHECK_UNDO_GAMES = 200;
+const int CHECK_UNDO_MARKS = 20;       // marks per game
+const int CHECK_UNDO_MAX_TURNS = 60;   // turns played past a mark
+const int CHECK_SAVE_GAMES = 200;
+const int CHECK_LIQUIDATION_CASES = 15000;
+const int CHECK_MAX_DEBT = 1500;
+const int CHECK_DICE_STREAMS = 3000;    // spans a few DICE_STREAM_BLOCKs
+const int CHECK_DICE_LOOKUPS = 300;
+const int CHECK_DICE_DRAWS = 256;      // draws compared per stream
+const int CHECK_TOURNAMENT_GAMES = 300;
+const int CHECK_TOURNAMENT_THREADS = 3;
+const int CHECK_CARD_SHUFFLES = 1000;
+const int CHECK_CARD_GAMES = 200;
+const int CHECK_CARD_DRAWS = DECK_SIZE + 4; // per game, so every deck goes round
+const int CHECK_CARD_POOR = 20;            // money of players made short before a draw
+const int CHECK_LANDING_GAMES = 50;
+const int CHECK_LANDING_TURNS = 2000;     // per game, of two players
+const double CHECK_LANDING_TOLERANCE = 0.003; // per square; a few standard errors
+const int CHECK_SERVER_COMMANDS = 1000;  // pipelined NEWs, more than one read's worth
+const int CHECK_SERVER_WAIT_MS = 5000;
+const char CHECK_SERVER_SOCKET[] = "build/Check/server.sock";
+const int CHECK_REPORTED_FAILURES = 5; // failures described in detail
+
+static DiceRng checkRng;
+
+static int randomBelow(int limit) {
+    return static_cast<int>(nextRandom(&checkRng) % limit);
+}
+
+// The ownership index and holdings lists agree with the squares: the
+// masks are what rebuilding them gives, and each player's list holds
+// every square they own once, each at its slot
+static bool indexConsistent(const GameState* game) {
+    GameState rebuilt = *game;
+    rebuildOwnershipIndex(&rebuilt, rebuilt.board->squares);
+    if (memcmp(rebuilt.ownedMasks, game->ownedMasks, sizeof(game->ownedMasks)) != 0 ||
+        rebuilt.mortgagedMask != game->mortgagedMask ||
+        memcmp(rebuilt.houseMasks, game->houseMasks, sizeof(game->houseMasks)) != 0) {
+        return false;
+    }
+    for (int i = 0; i < game->numPlayers; i++) {
+        const Player* player = &game->players[i];
+        if (player->propertyCount != countSquares(game->ownedMasks[i])) {
+            return false;
+        }
+        for (int j = 0; j < player->propertyCount; j++) {
+            const SquareState* square = &game->squares[player->ownedProperties[j]];
+            if (square->owner != i || square->slot != j) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Everything a game goes on from: players, squares, decks, turn progress
+// and the dice still to come
+static bool sameState(const GameState* a, const GameState* b) {
+    return memcmp(a->players, b->players, sizeof(a->players)) == 0 &&
+           memcmp(a->squares, b->squares, sizeof(a->squares)) == 0 &&
+           memcmp(a->ownedMasks, b->ownedMasks, sizeof(a->ownedMasks)) == 0 &&
+           a->mortgagedMask == b->mortgagedMask &&
+           memcmp(a->houseMasks, b->houseMasks, sizeof(a->houseMasks)) == 0 &&
+           memcmp(a->deckOrder, b->deckOrder, sizeof(a->deckOrder)) == 0 &&
+           memcmp(a->deckIndex, b->deckIndex, sizeof(a->deckIndex)) == 0 &&
+           a->currentPlayer == b->currentPlayer && a->gameOver == b->gameOver &&
+           memcmp(&a->turn, &b->turn, sizeof(TurnState)) == 0 &&
+           memcmp(&a->dice.rng, &b->dice.rng, sizeof(DiceRng)) == 0 && a->dice.next == b->dice.next &&
+           memcmp(a->dice.pairs + a->dice.next, b->dice.pairs + b->dice.next, DICE_BUFFER_SIZE - a->dice.next) == 0;
+}
+
+// A trade between the current player and anyone, picked at random; the
+// engine refuses the ones that aren't valid
+static void tryRandomTrade(GameState* game, const Property board[]) {
+    TradeOffer offer;
+    offer.fromPlayer = game->currentPlayer;
+    offer.toPlayer = randomBelow(game->numPlayers);
+    const Player* from = &game->players[offer.fromPlayer];
+    const Player* to = &game->players[offer.toPlayer];
+    offer.offeredProperty = (from->propertyCount > 0 && randomBelow(3) != 0) ? randomBelow(from->propertyCount) : -1;
+    offer.requestedProperty = to->propertyCount > 0 ? randomBelow(to->propertyCount) : -1;
+    offer.offeredMoney = randomBelow(50);
+    offer.requestedMoney = randomBelow(50);
+    if (offer.toPlayer != offer.fromPlayer) {
+        executeTrade(game, board, &offer);
+    }
+}
+
+// Something the current player might do between rolls, picked at random;
+// the engine refuses what isn't allowed
+static void tryRandomAction(GameState* game, const Property board[]) {
+    int square = randomBelow(game->board->size);
+    switch (randomBelow(5)) {
+        case 0:
+            tryRandomTrade(game, board);
+            break;
+        case 1:
+            buildHouse(game, board, square);
+            break;
+        case 2:
+            sellHouse(game, board, square);
+            break;
+        case 3:
+            mortgageProperty(game, board, square);
+            break;
+        case 4:
+            unmortgageProperty(game, board, square);
+            break;
+    }
+}
+
+// Plays seeded games with random trades, builds, sales, mortgages and
+// forced debts (so liquidation and bankruptcy move squares too), checking
+// the index after every turn and every action
+static bool checkOwnership() {
+    static GameState game;
+    int checked = 0;
+    int failures = 0;
+    
+    for (int g = 0; g < CHECK_OWNERSHIP_GAMES; g++) {
+        setupHeadlessGame(&game, activeBoard, 2 + randomBelow(MAX_PLAYERS - 1), &BASIC_BOT, CHECK_SEED + g);
+        const Property* board = game.board->squares;
+        bool consistent = true;
+        for (int t = 0; t < CHECK_OWNERSHIP_TURNS && consistent && !game.gameOver && !checkWinCondition(&game); t++) {
+            int actions = randomBelow(4);
+            for (int a = 0; a < actions && consistent; a++) {
+                tryRandomAction(&game, board);
+                consistent = indexConsistent(&game);
+                checked++;
+            }
+            if (randomBelow(20) == 0) {
+                game.players[game.currentPlayer].money -= 500 + randomBelow(2000);
+            }
+            playTurn(&game, board);
+            consistent = consistent && indexConsistent(&game);
+            checked++;
+            if (!consistent && ++failures <= CHECK_REPORTED_FAILURES) {
+                cout << "  game " << g << ", turn " << t << ": the ownership index doesn't match the squares\n";
+            }
+        }
+    }
+    
+    cout << "ownership: " << checked << " states, " << failures << " failed\n";
+    return failures == 0;
+}
+
+// Plays turns past a mark with random trades, builds, sales and
+// mortgages, random decision answers and forced debts (so bankruptcies
+// and liquidation get undone too), then undoes them and compares with a
+// copy taken at the mark. Every other game is on a board where houses
+// cost nothing, so builds and sales move no money.
+static bool checkUndo() {
+    static GameState game;
+    static GameState saved;
+    static UndoLog log;
+    static Board freeHouses;
+    freeHouses = *activeBoard;
+    for (int i = 0; i < freeHouses.size; i++) {
+        freeHouses.squares[i].houseCost = 0;
+    }
+    int marks = 0;
+    int failures = 0;
+    
+    for (int g = 0; g < CHECK_UNDO_GAMES; g++) {
+        const Board* layout = g % 2 == 0 ? activeBoard : &freeHouses;
+        setupHeadlessGame(&game, layout, 2 + randomBelow(MAX_PLAYERS - 1), &BASIC_BOT, CHECK_SEED + g);
+        const Property* board = game.board->squares;
+        int warmup = randomBelow(300);
+        for (int t = 0; t < warmup && !game.gameOver; t++) {
+            playTurn(&game, board);
+        }
+        attachUndoLog(&game, &log);
+        
+        for (int m = 0; m < CHECK_UNDO_MARKS; m++) {
+            // Marks are made between turns and, half the time, mid-turn
+            int decision = runTurn(&game, board);
+            if (decision != DECISION_NONE && randomBelow(2) == 0) {
+                resumeTurn(&game, board, controllerAnswer(&game, board, decision));
+            }
+            saved = game;
+            UndoMark mark = markUndo(&game);
+            
+            int turns = randomBelow(CHECK_UNDO_MAX_TURNS);
+            for (int t = 0; t < turns && !game.gameOver && !checkWinCondition(&game); t++) {
+                if (randomBelow(3) == 0) {
+                    tryRandomAction(&game, board);
+                }
+                if (randomBelow(7) == 0) {
+                    game.players[game.currentPlayer].money -= 3000;
+                    journalEvent(&game, JOURNAL_PAYMENT, game.currentPlayer, 0, 0, -3000);
+                }
+                decision = runTurn(&game, board);
+                while (decision != DECISION_NONE) {
+                    int answer = randomBelow(4) == 0 ? 1 + randomBelow(3) : controllerAnswer(&game, board, decision);
+                    decision = resumeTurn(&game, board, answer);
+                }
+            }
+            
+            bool undone = undoTo(&game, board, &mark);
+            marks++;
+            if (!undone || !sameState(&game, &saved) || !indexConsistent(&game)) {
+                if (++failures <= CHECK_REPORTED_FAILURES) {
+                    cout << "  game " << g << " mark " << m << ": "
+                         << (undone ? "state differs after undo" : "undo log overflowed") << '\n';
+                }
+                game = saved;
+                attachUndoLog(&game, &log);
+            }
+            
+            int further = randomBelow(10);
+            for (int t = 0; t < further && !game.gameOver; t++) {
+                playTurn(&game, board);
+            }
+        }
+        detachUndoLog(&game);
+    }
+    
+    cout << "undo: " << marks << " marks, " << failures << " failed\n";
+    return failures == 0;
+}
+
+// The fields a save holds, compared field by field rather than by bytes
+static bool sameSavedGame(const GameState* a, const PlayerNames* aNames, const GameState* b,
+                          const PlayerNames* bNames) {
+    if (a->numPlayers != b->numPlayers || a->currentPlayer != b->currentPlayer ||
+        memcmp(a->deckOrder, b->deckOrder, sizeof(a->deckOrder)) != 0 ||
+        memcmp(a->deckIndex, b->deckIndex, sizeof(a->deckIndex)) != 0 ||
+        memcmp(&a->dice.rng, &b->dice.rng, sizeof(DiceRng)) != 0 || a->dice.next != b->dice.next ||
+        memcmp(a->dice.pairs + a->dice.next, b->dice.pairs + b->dice.next, DICE_BUFFER_SIZE - a->dice.next) != 0) {
+        return false;
+    }
+    for (int i = 0; i < a->numPlayers; i++) {
+        const Player* p = &a->players[i];
+        const Player* q = &b->players[i];
+        if (p->money != q->money || p->position != q->position || p->inJail != q->inJail ||
+            p->jailTurns != q->jailTurns || p->bankrupt != q->bankrupt || p->computer != q->computer ||
+            p->getOutOfJailCards != q->getOutOfJailCards || p->propertyCount != q->propertyCount ||
+            memcmp(p->ownedProperties, q->ownedProperties, p->propertyCount * sizeof(p->ownedProperties[0])) != 0 ||
+            strcmp(aNames->name[i], bNames->name[i]) != 0) {
+            return false;
+        }
+    }
+    for (int i = 0; i < a->board->size; i++) {
+        if (a->squares[i].owner != b->squares[i].owner || a->squares[i].houses != b->squares[i].houses ||
+            a->squares[i].mortgaged != b->squares[i].mortgaged) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// States no game can reach, which a save must not load
+const int CHECK_IMPOSSIBLE_STATES = 4;
+static const char* const IMPOSSIBLE_STATES[CHECK_IMPOSSIBLE_STATES] = {
+    "an owned square that isn't a property",
+    "houses on a railroad or utility",
+    "houses on a mortgaged square",
+    "houses on a square nobody owns"
+};
+
+// Sets up the impossible state, consistently otherwise
+static void makeImpossible(GameState* game, int kind) {
+    const Property* board = game->board->squares;
+    int square = 0;
+    while (square < game->board->size &&
+           !(kind == 0 ? board[square].type < 1 || board[square].type > 3 :
+             kind == 1 ? board[square].type == 2 || board[square].type == 3 : board[square].type == 1)) {
+        square++;
+    }
+    if (kind != 3) {
+        setPropertyOwner(game, board, square, 0);
+    }
+    if (kind != 0) {
+        setHouses(game, square, 1);
+    }
+    if (kind == 2) {
+        setMortgaged(game, square, true);
+    }
+}
+
+// Saves bot games at random points. Each must decode to the game and save
+// again to the same bytes; every prefix, the save with a byte added, and
+// the save with any one byte changed must be rejected without the target
+// game changing. So must saves of impossible states with a valid checksum.
+static bool checkSave() {
+    static GameState game;
+    static GameState decoded;
+    static GameState untouched;
+    static PlayerNames names;
+    static PlayerNames decodedNames;
+    unsigned char buffer[MAX_SAVE_SIZE + 1];
+    unsigned char again[MAX_SAVE_SIZE];
+    const int flips[] = {0x01, 0x80, 0xFF};
+    int saves = 0;
+    int rejections = 0;
+    int failures = 0;
+    
+    for (int g = 0; g < CHECK_SAVE_GAMES; g++) {
+        setupHeadlessGame(&game, activeBoard, 2 + randomBelow(MAX_PLAYERS - 1), &BASIC_BOT, CHECK_SEED + g);
+        for (int i = 0; i < game.numPlayers; i++) {
+            snprintf(names.name[i], MAX_NAME_LENGTH, "Player %d%.*s", i + 1, randomBelow(8), "********");
+        }
+        game.names = &names;
+        int turns = randomBelow(500);
+        for (int t = 0; t < turns && !game.gameOver; t++) {
+            playTurn(&game, game.board->squares);
+        }
+        
+        int length = encodeGame(&game, buffer, MAX_SAVE_SIZE);
+        decoded.board = activeBoard;
+        saves++;
+        // Loaders rebuild the ownership index, which saves don't hold
+        bool roundTrip = length > 0 && decodeGame(buffer, length, &decoded, &decodedNames) == SAVE_OK;
+        if (roundTrip) {
+            rebuildOwnershipIndex(&decoded, decoded.board->squares);
+            roundTrip = sameSavedGame(&game, &names, &decoded, &decodedNames) &&
+                        encodeGame(&decoded, again, MAX_SAVE_SIZE) == length && memcmp(again, buffer, length) == 0;
+        }
+        if (!roundTrip) {
+            if (++failures <= CHECK_REPORTED_FAILURES) {
+                cout << "  game " << g << ": the save didn't decode to the game it was made from\n";
+            }
+            continue;
+        }
+        
+        untouched = decoded;
+        PlayerNames untouchedNames = decodedNames;
+        for (int cut = 0; cut <= length + 1; cut++) {
+            if (cut == length) {
+                continue;
+            }
+            buffer[length] = 0;
+            rejections++;
+            if (decodeGame(buffer, cut, &decoded, &decodedNames) == SAVE_OK &&
+                ++failures <= CHECK_REPORTED_FAILURES) {
+                cout << "  game " << g << ": a save cut to " << cut << " of " << length << " bytes loaded\n";
+            }
+        }
+        for (int i = 0; i < length; i++) {
+            for (int flip : flips) {
+                buffer[i] ^= flip;
+                rejections++;
+                if (decodeGame(buffer, length, &decoded, &decodedNames) == SAVE_OK &&
+                    ++failures <= CHECK_REPORTED_FAILURES) {
+                    cout << "  game " << g << ": a save with byte " << i << " changed loaded\n";
+                }
+                buffer[i] ^= flip;
+            }
+        }
+        if (!sameState(&decoded, &untouched) ||
+            !sameSavedGame(&decoded, &decodedNames, &untouched, &untouchedNames)) {
+            if (++failures <= CHECK_REPORTED_FAILURES) {
+                cout << "  game " << g << ": a rejected save changed the game it was loaded into\n";
+            }
+        }
+    }
+    
+    for (int kind = 0; kind < CHECK_IMPOSSIBLE_STATES; kind++) {
+        setupHeadlessGame(&game, activeBoard, 2, &BASIC_BOT, CHECK_SEED);
+        game.names = &names;
+        makeImpossible(&game, kind);
+        int length = encodeGame(&game, buffer, MAX_SAVE_SIZE);
+        untouched = decoded;
+        rejections++;
+        if (length > 0 && decodeGame(buffer, length, &decoded, &decodedNames) == SAVE_OK) {
+            failures++;
+            cout << "  a save with " << IMPOSSIBLE_STATES[kind] << " loaded\n";
+        } else if (!sameState(&decoded, &untouched)) {
+            failures++;
+            cout << "  a save with " << IMPOSSIBLE_STATES[kind] << " changed the game it was loaded into\n";
+        }
+    }
+    
+    cout << "save: " << saves << " round trips, " << rejections << " bad saves, " << failures << " failed\n";
+    return failures == 0;
+}
+
+// Exhaustive least loss for the current player to get out of debt, over
+// every legal order of house sales and mortgages (memoized on the squares'
+// states). Huge if no order gets there.
+const int NO_WAY_OUT = 1 << 29;
+
+struct LiquidationSearch {
+    const Property* board;
+    int owned[MAX_BOARD_SIZE];
+    int numOwned;
+    map<string, int> leastLoss;
+};
+
+static int exhaustiveLoss(const GameState* game, LiquidationSearch* search) {
+    const Player* player = &game->players[game->currentPlayer];
+    if (player->money >= 0) {
+        return 0;
+    }
+    string key;
+    for (int i = 0; i < search->numOwned; i++) {
+        const SquareState* square = &game->squares[search->owned[i]];
+        key += static_cast<char>(square->houses * 2 + square->mortgaged);
+    }
+    map<string, int>::iterator known = search->leastLoss.find(key);
+    if (known != search->leastLoss.end()) {
+        return known->second;
+    }
+    
+    const Property* board = search->board;
+    int best = NO_WAY_OUT;
+    GameState next;
+    for (int i = 0; i < search->numOwned; i++) {
+        int square = search->owned[i];
+        for (int action = LIQUIDATE_SELL_HOUSE; action <= LIQUIDATE_MORTGAGE; action++) {
+            next = *game;
+            if (action == LIQUIDATE_SELL_HOUSE) {
+                sellHouse(&next, board, square);
+            } else {
+                mortgageProperty(&next, board, square);
+            }
+            int raised = next.players[next.currentPlayer].money - player->money;
+            if (raised == 0) {
+                continue; // not allowed
+            }
+            int loss = action == LIQUIDATE_SELL_HOUSE ? board[square].houseCost - raised
+                                                      : board[square].unmortgageCost - board[square].mortgageValue;
+            int rest = exhaustiveLoss(&next, search);
+            if (rest != NO_WAY_OUT && loss + rest < best) {
+                best = loss + rest;
+            }
+        }
+    }
+    search->leastLoss[key] = best;
+    return best;
+}
+
+// Random holdings for player 0: scattered squares, complete groups built
+// evenly, sometimes one built square handed to the opponent (so a group
+// has houses the player can't sell), some bare squares mortgaged, and a
+// random debt. Debts within MAX_LIQUIDATION_STATES dollars are planned in
+// exact units, so the plan must lose exactly the exhaustive minimum; for
+// larger ones it may lose more but must still cover the debt.
+static bool checkLiquidation() {
+    static GameState game;
+    static GameState executed;
+    LiquidationSearch search;
+    LiquidationPlan plan;
+    int exact = 0;
+    int failures = 0;
+    
+    for (int c = 0; c < CHECK_LIQUIDATION_CASES; c++) {
+        setupHeadlessGame(&game, activeBoard, 2, &BASIC_BOT, CHECK_SEED);
+        const Property* board = game.board->squares;
+        const Board* layout = game.board;
+        search.board = board;
+        search.numOwned = 0;
+        search.leastLoss.clear();
+        
+        for (int i = 0; i < layout->size; i++) {
+            if (board[i].type >= 1 && board[i].type <= 3 && search.numOwned < 7 && randomBelow(4) == 0) {
+                setPropertyOwner(&game, board, i, 0);
+                search.owned[search.numOwned++] = i;
+            }
+        }
+        for (int color = 0; color < NUM_COLORS; color++) {
+            SquareMask group = layout->colorMasks[color];
+            if (group == 0 || (group & game.ownedMasks[0]) != group) {
+                continue;
+            }
+            int level = randomBelow(HOTEL);
+            for (int i = 0; i < layout->size; i++) {
+                if (group & squareBit(i)) {
+                    setHouses(&game, i, level + randomBelow(2));
+                }
+            }
+        }
+        if (randomBelow(3) == 0) {
+            for (int i = 0; i < search.numOwned; i++) {
+                if (game.squares[search.owned[i]].houses > 0) {
+                    setPropertyOwner(&game, board, search.owned[i], 1);
+                    search.owned[i] = search.owned[--search.numOwned];
+                    break;
+                }
+            }
+        }
+        for (int i = 0; i < search.numOwned; i++) {
+            if (game.squares[search.owned[i]].houses == 0 && randomBelow(3) == 0) {
+                setMortgaged(&game, search.owned[i], true);
+            }
+        }
+        int debt = 1 + randomBelow(CHECK_MAX_DEBT);
+        game.players[0].money = -debt;
+        
+        int least = exhaustiveLoss(&game, &search);
+        bool planned = planLiquidation(&game, board, debt, &plan);
+        bool inExactUnits = debt <= MAX_LIQUIDATION_STATES;
+        exact += inExactUnits;
+        
+        const char* problem = 0;
+        if (!planned) {
+            if (least != NO_WAY_OUT) {
+                problem = "no plan, but there is a way out";
+            }
+        } else {
+            executed = game;
+            executeLiquidation(&executed, board, &plan);
+            if (executed.players[0].money < 0) {
+                problem = "the plan doesn't cover the debt";
+            } else if (executed.players[0].money + debt != plan.cash) {
+                problem = "the plan raised a different amount than it says";
+            } else if (plan.loss < least || (inExactUnits && plan.loss != least)) {
+                problem = "the plan's loss isn't the least";
+            }
+        }
+        if (problem != 0 && ++failures <= CHECK_REPORTED_FAILURES) {
+            cout << "  case " << c << ", debt $" << debt << ": " << problem << " (plan loses $"
+                 << (planned ? plan.loss : 0) << ", least is $" << least << ")\n";
+        }
+    }
+    
+    cout << "liquidation: " << CHECK_LIQUIDATION_CASES << " cases (" << exact << " in exact units), "
+         << failures << " failed\n";
+    return failures == 0;
+}
+
+static bool sameRng(const DiceRng* a, const DiceRng* b) {
+    return memcmp(a->s, b->s, sizeof(a->s)) == 0;
+}
+
+// One DiceStreams asked for streams in random order, against a fresh one
+// per lookup (which only ever moves forward from stream 0) and, within the
+// first block, against splitting a generator stream by stream. Then the
+// first draws of every stream must all differ, and tournaments must come
+// out the same on one thread as on several.
+static bool checkDice() {
+    int failures = 0;
+    
+    DiceStreams reused;
+    seedDiceStreams(&reused, CHECK_SEED);
+    DiceRng found, expected;
+    for (int i = 0; i < CHECK_DICE_LOOKUPS; i++) {
+        long long n = randomBelow(CHECK_DICE_STREAMS);
+        DiceStreams fresh;
+        seedDiceStreams(&fresh, CHECK_SEED);
+        findDiceStream(&reused, n, &found);
+        findDiceStream(&fresh, n, &expected);
+        if (!sameRng(&found, &expected) && ++failures <= CHECK_REPORTED_FAILURES) {
+            cout << "  stream " << n << " depends on the streams found before it\n";
+        }
+    }
+    
+    DiceRng parent;
+    seedDiceRng(&parent, CHECK_SEED);
+    for (long long n = 0; n < DICE_STREAM_BLOCK; n++) {
+        splitDiceRng(&parent, &expected);
+        findDiceStream(&reused, n, &found);
+        if (!sameRng(&found, &expected) && ++failures <= CHECK_REPORTED_FAILURES) {
+            cout << "  stream " << n << " isn't the " << n << "th split of stream 0\n";
+        }
+    }
+    
+    set<unsigned long long> draws;
+    int repeats = 0;
+    for (long long n = 0; n < CHECK_DICE_STREAMS; n++) {
+        findDiceStream(&reused, n, &found);
+        for (int i = 0; i < CHECK_DICE_DRAWS; i++) {
+            if (!draws.insert(nextRandom(&found)).second) {
+                repeats++;
+            }
+        }
+    }
+    if (repeats > 0 && ++failures <= CHECK_REPORTED_FAILURES) {
+        cout << "  " << repeats << " draws repeated across streams\n";
+    }
+    
+    TournamentResult single = runTournament(CHECK_TOURNAMENT_GAMES, 1, CHECK_SEED, &BASIC_BOT, activeBoard, 0);
+    TournamentResult parallel = runTournament(CHECK_TOURNAMENT_GAMES, CHECK_TOURNAMENT_THREADS, CHECK_SEED,
+                                              &BASIC_BOT, activeBoard, 0);
+    if ((memcmp(single.wins, parallel.wins, sizeof(single.wins)) != 0 || single.unfinished != parallel.unfinished ||
+         single.totalTurns != parallel.totalTurns || single.bankruptcies != parallel.bankruptcies ||
+         single.totalBankruptcyTurns != parallel.totalBankruptcyTurns) &&
+        ++failures <= CHECK_REPORTED_FAILURES) {
+        cout << "  a tournament on " << CHECK_TOURNAMENT_THREADS << " threads differs from one on 1\n";
+    }
+    
+    cout << "dice: " << CHECK_DICE_LOOKUPS << " lookups, " << CHECK_DICE_STREAMS << " streams, "
+         << CHECK_TOURNAMENT_GAMES << "-game tournaments, " << failures << " failed\n";
+    return failures == 0;
+}
+
+// The square a moving card takes the player to, found by walking the
+// board rather than through masks, and whether it passes GO
+static int expectedDestination(const Board* board, const Card& card, int square, bool* passesGo) {
+    int destination = square;
+    if (card.actionType == CARD_MOVE_TO) {
+        destination = card.actionValue;
+    } else if (card.actionType == CARD_MOVE_BY) {
+        destination = (square + card.actionValue + board->size) % board->size;
+    } else {
+        int type = card.actionType == CARD_NEAREST_RAILROAD ? 2 : 3;
+        for (int step = 1; step <= board->size; step++) {
+            if (board->squares[(square + step) % board->size].type == type) {
+                destination = (square + step) % board->size;
+                break;
+            }
+        }
+    }
+    *passesGo = card.actionType != CARD_MOVE_BY && destination < square;
+    return destination;
+}
+
+// Houses and hotels the player owns, counted square by square
+static int expectedRepairs(const GameState* game, const Card& card, int playerNum) {
+    int amount = 0;
+    for (int i = 0; i < game->board->size; i++) {
+        if (game->squares[i].owner == playerNum) {
+            int houses = game->squares[i].houses;
+            amount += houses == HOTEL ? card.hotelValue : houses * card.actionValue;
+        }
+    }
+    return amount;
+}
+
+// Draws from bot game positions, some with the other players nearly broke,
+// against what each card says it does. A player a card leaves in debt must
+// have raised the money or gone bankrupt before drawCard returns.
+static bool checkCards() {
+    static GameState game;
+    static GameState before;
+    int failures = 0;
+    
+    int dealt[NUM_DECKS][DECK_SIZE][DECK_SIZE] = {}; // [deck][card][slot]
+    for (int g = 0; g < CHECK_CARD_SHUFFLES; g++) {
+        setupHeadlessGame(&game, activeBoard, 2, &BASIC_BOT, CHECK_SEED + g);
+        for (int deck = 0; deck < NUM_DECKS; deck++) {
+            unsigned int seen = 0;
+            for (int slot = 0; slot < DECK_SIZE; slot++) {
+                int card = game.deckOrder[deck][slot];
+                seen |= card < DECK_SIZE ? 1u << card : 0;
+                dealt[deck][card % DECK_SIZE][slot]++;
+            }
+            if (seen != (1u << DECK_SIZE) - 1 && ++failures <= CHECK_REPORTED_FAILURES) {
+                cout << "  seed " << CHECK_SEED + g << ": deck " << deck << " isn't a permutation\n";
+            }
+        }
+    }
+    for (int deck = 0; deck < NUM_DECKS; deck++) {
+        for (int card = 0; card < DECK_SIZE; card++) {
+            for (int slot = 0; slot < DECK_SIZE; slot++) {
+                if (dealt[deck][card][slot] == 0 && ++failures <= CHECK_REPORTED_FAILURES) {
+                    cout << "  deck " << deck << " never deals card " << card << " in slot " << slot << '\n';
+                }
+            }
+        }
+    }
+    
+    int draws = 0;
+    for (int g = 0; g < CHECK_CARD_GAMES; g++) {
+        setupHeadlessGame(&game, activeBoard, 2 + randomBelow(MAX_PLAYERS - 1), &BASIC_BOT, CHECK_SEED + g);
+        int turns = randomBelow(300);
+        for (int t = 0; t < turns && !game.gameOver; t++) {
+            playTurn(&game, game.board->squares);
+        }
+        const Board* layout = game.board;
+        const Property* board = layout->squares;
+        int deck = g % NUM_DECKS;
+        int firstSlot = game.deckIndex[deck];
+        
+        for (int d = 0; d < CHECK_CARD_DRAWS; d++) {
+            // The drawer is any player still in, anywhere, out of jail
+            int drawer = randomBelow(game.numPlayers);
+            while (game.players[drawer].bankrupt) {
+                drawer = (drawer + 1) % game.numPlayers;
+            }
+            game.currentPlayer = drawer;
+            game.turn.cardRent = 0;
+            game.players[drawer].position = randomBelow(layout->size);
+            game.players[drawer].inJail = false;
+            game.players[drawer].jailTurns = 0;
+            if (randomBelow(2) == 0) {
+                for (int i = 0; i < game.numPlayers; i++) {
+                    if (i != drawer) {
+                        game.players[i].money = randomBelow(CHECK_CARD_POOR);
+                    }
+                }
+            }
+            before = game;
+            
+            int slot = before.deckIndex[deck];
+            const Card& card = layout->cards[deck][before.deckOrder[deck][slot]];
+            drawCard(&game, board, deck);
+            draws++;
+            
+            const Player* was = &before.players[drawer];
+            const Player* now = &game.players[drawer];
+            int money = was->money;
+            int position = was->position;
+            int jailCards = was->getOutOfJailCards;
+            int cardRent = 0;
+            bool jailed = false;
+            switch (card.actionType) {
+                case CARD_MOVE_TO:
+                case CARD_MOVE_BY:
+                case CARD_NEAREST_RAILROAD:
+                case CARD_NEAREST_UTILITY: {
+                    bool passesGo;
+                    position = expectedDestination(layout, card, was->position, &passesGo);
+                    money += passesGo ? layout->goSalary : 0;
+                    if (card.actionType == CARD_NEAREST_RAILROAD || card.actionType == CARD_NEAREST_UTILITY) {
+                        cardRent = card.actionType;
+                    }
+                    break;
+                }
+                case CARD_MONEY:
+                    money += card.actionValue;
+                    break;
+                case CARD_REPAIRS:
+                    money += expectedRepairs(&before, card, drawer);
+                    break;
+                case CARD_EACH_PLAYER:
+                    for (int i = 0; i < before.numPlayers; i++) {
+                        if (i != drawer && !before.players[i].bankrupt) {
+                            money += card.actionValue;
+                        }
+                    }
+                    break;
+                case CARD_JAIL_FREE:
+                    jailCards++;
+                    break;
+                case CARD_GO_TO_JAIL:
+                    position = layout->jailSquare;
+                    jailed = true;
+                    break;
+            }
+            
+            bool right = game.currentPlayer == drawer && now->money == money && now->position == position &&
+                         now->getOutOfJailCards == jailCards && now->inJail == jailed &&
+                         game.turn.cardRent == cardRent && game.deckIndex[deck] == (slot + 1) % DECK_SIZE &&
+                         game.deckIndex[1 - deck] == before.deckIndex[1 - deck];
+            
+            // Everyone else pays exactly what the card asks, and no one it
+            // leaves in debt stays there
+            for (int i = 0; i < game.numPlayers; i++) {
+                if (i == drawer || before.players[i].bankrupt) {
+                    continue;
+                }
+                const Player* payer = &game.players[i];
+                int owed = card.actionType == CARD_EACH_PLAYER ? card.actionValue : 0;
+                if (owed <= 0 || before.players[i].money >= owed) {
+                    right = right && payer->money == before.players[i].money - owed && !payer->bankrupt &&
+                            payer->propertyCount == before.players[i].propertyCount;
+                } else {
+                    right = right && (payer->bankrupt || payer->money >= 0);
+                }
+            }
+            right = right && indexConsistent(&game);
+            if (!right && ++failures <= CHECK_REPORTED_FAILURES) {
+                cout << "  game " << g << ", draw " << d << ": \"" << card.text << "\" wasn't carried out as written\n";
+            }
+            
+            // As the rest of the turn would
+            if (now->money < 0) {
+                handleBankruptcy(&game, board);
+            }
+        }
+        
+        // More draws than cards: the deck went round to just past where it was
+        if (game.deckIndex[deck] != (firstSlot + CHECK_CARD_DRAWS) % DECK_SIZE &&
+            ++failures <= CHECK_REPORTED_FAILURES) {
+            cout << "  game " << g << ": " << CHECK_CARD_DRAWS << " draws from slot " << firstSlot
+                 << " left the deck at slot " << game.deckIndex[deck] << '\n';
+        }
+    }
+    
+    cout << "cards: " << CHECK_CARD_SHUFFLES << " shuffles, " << draws << " draws, " << failures << " failed\n";
+    return failures == 0;
+}
+
+static bool neverBuys(const GameState* game, const Property board[], int propertyIndex, void* context) {
+    return false;
+}
+
+// Pays or rolls as the strategy in context says
+static int jailStrategyAnswer(const GameState* game, const Property board[], void* context) {
+    return *static_cast<int*>(context) == JAIL_STRATEGY_PAY ? 1 : 3;
+}
+
+// Counts the Markov state a player is in at the end of a roll
+static void countLanding(const GameState* game, int playerNum, long long counts[]) {
+    const Player* player = &game->players[playerNum];
+    counts[player->inJail ? game->board->size + player->jailTurns : player->position]++;
+}
+
+// Solves for each jail strategy, then plays seeded games through the
+// turn engine with players who never buy (so there is no rent, and money
+// is topped up so no one goes bankrupt), counting where each roll ends:
+// at a mid-turn roll decision after doubles, and at the end of each turn.
+static bool checkLanding() {
+    static GameState game;
+    int failures = 0;
+    long long rolls = 0;
+    
+    for (int strategy = JAIL_STRATEGY_ROLL; strategy <= JAIL_STRATEGY_PAY; strategy++) {
+        LandingProbabilities solved = solveLandingProbabilities(activeBoard, strategy);
+        double total = solved.inJail;
+        for (int i = 0; i < activeBoard->size; i++) {
+            total += solved.square[i];
+        }
+        if ((total < 1.0 - 1e-9 || total > 1.0 + 1e-9) && ++failures <= CHECK_REPORTED_FAILURES) {
+            cout << "  strategy " << strategy << ": the probabilities sum to " << total << '\n';
+        }
+        
+        PlayerController walker = BASIC_BOT;
+        walker.wantsToBuy = neverBuys;
+        walker.chooseJailOption = jailStrategyAnswer;
+        walker.context = &strategy;
+        long long counts[MARKOV_STATES] = {};
+        long long strategyRolls = 0;
+        for (int g = 0; g < CHECK_LANDING_GAMES; g++) {
+            setupHeadlessGame(&game, activeBoard, 2, &walker, CHECK_SEED + g);
+            const Property* board = game.board->squares;
+            for (int t = 0; t < CHECK_LANDING_TURNS; t++) {
+                int mover = game.currentPlayer;
+                game.players[mover].money = game.board->startingMoney;
+                int decision = runTurn(&game, board);
+                while (decision != DECISION_NONE) {
+                    if (decision == DECISION_ROLL && game.turn.rolls > 0) {
+                        countLanding(&game, mover, counts);
+                        strategyRolls++;
+                    }
+                    decision = resumeTurn(&game, board, controllerAnswer(&game, board, decision));
+                }
+                countLanding(&game, mover, counts);
+                strategyRolls++;
+            }
+        }
+        rolls += strategyRolls;
+        
+        double inJail = 0.0;
+        for (int i = 0; i < JAIL_STATES; i++) {
+            inJail += static_cast<double>(counts[activeBoard->size + i]) / strategyRolls;
+        }
+        double worst = inJail - solved.inJail;
+        int worstSquare = -1;
+        for (int i = 0; i < activeBoard->size; i++) {
+            double difference = static_cast<double>(counts[i]) / strategyRolls - solved.square[i];
+            if ((difference < 0 ? -difference : difference) > (worst < 0 ? -worst : worst)) {
+                worst = difference;
+                worstSquare = i;
+            }
+        }
+        if ((worst < -CHECK_LANDING_TOLERANCE || worst > CHECK_LANDING_TOLERANCE) &&
+            ++failures <= CHECK_REPORTED_FAILURES) {
+            cout << "  strategy " << strategy << ": "
+                 << (worstSquare == -1 ? "In Jail" : activeBoard->squares[worstSquare].name)
+                 << " is off by " << worst << " from the games\n";
+        }
+    }
+    
+    cout << "landing: " << rolls << " rolls, " << failures << " failed\n";
+    return failures == 0;
+}
+
+// Connects to the check's server, waiting for it to start listening
+static int connectToServer() {
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, CHECK_SERVER_SOCKET);
+    for (int waited = 0; waited < CHECK_SERVER_WAIT_MS; waited += 10) {
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0) {
+            return fd;
+        }
+        close(fd);
+        usleep(10000);
+    }
+    return -1;
+}
+
+static bool sendAll(int fd, const string& text) {
+    for (size_t done = 0; done < text.size(); ) {
+        ssize_t sent = send(fd, text.data() + done, text.size() - done, MSG_NOSIGNAL);
+        if (sent <= 0) {
+            return false;
+        }
+        done += sent;
+    }
+    return true;
+}
+
+// Sends commands, closes the sending side and reads replies until the
+// server closes the connection
+static string askServer(const string& commands) {
+    int fd = connectToServer();
+    if (fd == -1) {
+        return "";
+    }
+    string replies;
+    if (sendAll(fd, commands) && shutdown(fd, SHUT_WR) == 0) {
+        char buffer[4096];
+        ssize_t received;
+        while ((received = recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+            replies.append(buffer, received);
+        }
+    }
+    close(fd);
+    return replies;
+}
+
+// One client pipelines NEWs and closes only its sending side, so it must
+// get a reply to each. Another pipelines as many and closes outright, so
+// it gets none; its games must all be made anyway. Games are numbered in
+// order from 0, so the last one made is the one to look for.
+static bool checkServer() {
+    cout << flush;
+    pid_t child = fork();
+    if (child == 0) {
+        if (freopen("/dev/null", "w", stdout) == 0) {
+            _exit(1);
+        }
+        runServer(CHECK_SERVER_SOCKET, 2, 2 * CHECK_SERVER_COMMANDS);
+        _exit(1);
+    }
+    int failures = 0;
+    string commands;
+    for (int i = 0; i < CHECK_SERVER_COMMANDS; i++) {
+        commands += "NEW 2\n";
+    }
+    
+    string replies = askServer(commands);
+    int okReplies = 0;
+    for (size_t line = 0; line < replies.size(); line = replies.find('\n', line) + 1) {
+        okReplies += (replies.compare(line, 3, "OK ") == 0);
+        if (replies.find('\n', line) == string::npos) {
+            break;
+        }
+    }
+    if (okReplies != CHECK_SERVER_COMMANDS) {
+        failures++;
+        cout << "  a half-closed client got " << okReplies << " of " << CHECK_SERVER_COMMANDS << " replies\n";
+    }
+    
+    int fd = connectToServer();
+    if (fd != -1) {
+        sendAll(fd, commands);
+        close(fd);
+    }
+    string lastGame = "STATE " + to_string(2 * CHECK_SERVER_COMMANDS - 1) + "\n";
+    bool made = false;
+    for (int waited = 0; waited < CHECK_SERVER_WAIT_MS && !made; waited += 10) {
+        made = askServer(lastGame).compare(0, 3, "OK ") == 0;
+        if (!made) {
+            usleep(10000);
+        }
+    }
+    if (!made) {
+        failures++;
+        cout << "  commands from a client that closed were lost\n";
+    }
+    
+    kill(child, SIGTERM);
+    waitpid(child, 0, 0);
+    unlink(CHECK_SERVER_SOCKET);
+    cout << "server: " << 2 * CHECK_SERVER_COMMANDS << " pipelined commands, " << failures << " failed\n";
+    return failures == 0;
+}
+
+int main() {
+    seedDiceRng(&checkRng, CHECK_SEED);
+    bool passed = true;
+    passed = checkOwnership() && passed;
+    passed = checkUndo() && passed;
+    passed = checkSave() && passed;
+    passed = checkLiquidation() && passed;
+    passed = checkDice() && passed;
+    passed = checkCards() && passed;
+    passed = checkLanding() && passed;
+    passed = checkServer() && passed;
+    
+    cout << (passed ? "All checks passed.\n" : "Some checks failed.\n");
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,146 @@
+#include "dice.h"
+
+// Pair codes for the 36 equally likely outcomes of two dice
+static const unsigned char PAIR_CODES[36] = {
+    0x11, 0x12, 0x13, 0x14, 0x15, 0x16,
+    0x21, 0x22, 0x23, 0x24, 0x25, 0x26,
+    0x31, 0x32, 0x33, 0x34, 0x35, 0x36,
+    0x41, 0x42, 0x43, 0x44, 0x45, 0x46,
+    0x51, 0x52, 0x53, 0x54, 0x55, 0x56,
+    0x61, 0x62, 0x63, 0x64, 0x65, 0x66
+};
+
+// Bytes at or above this value are rejected: 252 = 7 * 36, so the bytes
+// that remain map onto the 36 outcomes with no modulo bias
+const int PAIR_BYTE_LIMIT = 252;
+
+static inline unsigned long long rotateLeft(unsigned long long x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+static unsigned long long splitMix(unsigned long long* state) {
+    unsigned long long z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Expands a 64-bit seed into a full generator state
+void seedDiceRng(DiceRng* rng, unsigned long long seed) {
+    for (int i = 0; i < 4; i++) {
+        rng->s[i] = splitMix(&seed);
+    }
+}
+
+unsigned long long nextRandom(DiceRng* rng) {
+    unsigned long long* s = rng->s;
+    unsigned long long result = rotateLeft(s[1] * 5, 7) * 9;
+    unsigned long long t = s[1] << 17;
+    
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotateLeft(s[3], 45);
+    
+    return result;
+}
+
+// Jump polynomials for xoshiro256**: 2^128 and 2^192 draws ahead
+static const unsigned long long JUMP[4] = {
+    0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL,
+    0xA9582618E03FC9AAULL, 0x39ABDC4529B1661CULL
+};
+static const unsigned long long LONG_JUMP[4] = {
+    0x76E15D3EFEFDCBBFULL, 0xC5004E441C522FB3ULL,
+    0x77710069854EE241ULL, 0x39109BB02ACBE635ULL
+};
+
+static void jumpDiceRng(DiceRng* rng, const unsigned long long polynomial[4]) {
+    unsigned long long s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    for (int i = 0; i < 4; i++) {
+        for (int b = 0; b < 64; b++) {
+            if (polynomial[i] & (1ULL << b)) {
+                s0 ^= rng->s[0];
+                s1 ^= rng->s[1];
+                s2 ^= rng->s[2];
+                s3 ^= rng->s[3];
+            }
+            nextRandom(rng);
+        }
+    }
+    rng->s[0] = s0;
+    rng->s[1] = s1;
+    rng->s[2] = s2;
+    rng->s[3] = s3;
+}
+
+// Gives child the parent's current stream and moves the parent 2^128 draws
+// ahead, so the two never overlap. Split repeatedly for more streams.
+void splitDiceRng(DiceRng* parent, DiceRng* child) {
+    *child = *parent;
+    jumpDiceRng(parent, JUMP);
+}
+
+// Fills count pair codes; each 64-bit draw yields up to eight pairs
+void fillDicePairs(DiceRng* rng, unsigned char pairs[], int count) {
+    int filled = 0;
+    while (filled < count) {
+        unsigned long long bits = nextRandom(rng);
+        for (int i = 0; i < 8 && filled < count; i++) {
+            int byte = static_cast<int>(bits & 0xFF);
+            bits >>= 8;
+            if (byte < PAIR_BYTE_LIMIT) {
+                pairs[filled++] = PAIR_CODES[byte % 36];
+            }
+        }
+    }
+}
+
+void seedDice(Dice* dice, unsigned long long seed) {
+    seedDiceRng(&dice->rng, seed);
+    dice->next = DICE_BUFFER_SIZE; // First roll fills the buffer
+}
+
+void splitDice(Dice* parent, Dice* child) {
+    splitDiceRng(&parent->rng, &child->rng);
+    child->next = DICE_BUFFER_SIZE;
+}
+
+void refillDice(Dice* dice) {
+    fillDicePairs(&dice->rng, dice->pairs, DICE_BUFFER_SIZE);
+    dice->next = 0;
+}
+
+void seedDiceStreams(DiceStreams* streams, unsigned long long seed) {
+    seedDiceRng(&streams->first, seed);
+    streams->block = streams->first;
+    streams->current = streams->first;
+    streams->number = 0;
+}
+
+// Sets rng to stream n (see dice.h)
+void findDiceStream(DiceStreams* streams, long long n, DiceRng* rng) {
+    long long wantedBlock = n - n % DICE_STREAM_BLOCK;
+    long long block = streams->number - streams->number % DICE_STREAM_BLOCK;
+    if (wantedBlock < block) {
+        streams->block = streams->first;
+        block = 0;
+    }
+    if (wantedBlock != block || n < streams->number) {
+        streams->current = streams->block;
+        streams->number = block;
+    }
+    while (block < wantedBlock) {
+        jumpDiceRng(&streams->block, LONG_JUMP);
+        block += DICE_STREAM_BLOCK;
+        streams->current = streams->block;
+        streams->number = block;
+    }
+    while (streams->number < n) {
+        jumpDiceRng(&streams->current, JUMP);
+        streams->number++;
+    }
+    *rng = streams->current;
+}
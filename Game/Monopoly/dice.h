@@ -0,0 +1,55 @@
+#ifndef DICE_H
+#define DICE_H
+
+// Pre-rolled dice pairs kept per game between refills
+const int DICE_BUFFER_SIZE = 64;
+
+// xoshiro256** generator state
+struct DiceRng {
+    unsigned long long s[4];
+};
+
+// A generator plus a buffer of pre-rolled pairs. Each pair is stored as
+// (die1 << 4) | die2 so a roll is one byte load and two bit operations.
+struct Dice {
+    DiceRng rng;
+    unsigned char pairs[DICE_BUFFER_SIZE];
+    int next;
+};
+
+// Numbered streams for parallel runs. Stream n starts 2^128 draws after
+// stream n - 1 (the generator's jump), and each block of
+// DICE_STREAM_BLOCK streams starts 2^192 draws after the block before
+// (its long jump). No two streams of a seed share a draw unless one of
+// them makes 2^128 draws, for any stream number a long long holds; a
+// seed hashed per game would only make overlap unlikely. Finding the
+// stream after the last one found costs one jump, so a worker playing
+// games in order pays one jump per game.
+const long long DICE_STREAM_BLOCK = 1024;
+
+struct DiceStreams {
+    DiceRng first;   // stream 0
+    DiceRng block;   // first stream of the block holding current
+    DiceRng current;
+    long long number; // current's stream number
+};
+
+// Function declarations
+void seedDiceRng(DiceRng*, unsigned long long);
+void splitDiceRng(DiceRng*, DiceRng*);
+unsigned long long nextRandom(DiceRng*);
+void fillDicePairs(DiceRng*, unsigned char[], int);
+void seedDice(Dice*, unsigned long long);
+void splitDice(Dice*, Dice*);
+void refillDice(Dice*);
+void seedDiceStreams(DiceStreams*, unsigned long long);
+void findDiceStream(DiceStreams*, long long, DiceRng*);
+
+inline int nextDicePair(Dice* dice) {
+    if (dice->next == DICE_BUFFER_SIZE) {
+        refillDice(dice);
+    }
+    return dice->pairs[dice->next++];
+}
+
+#endif
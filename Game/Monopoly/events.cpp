@@ -0,0 +1,121 @@
+#include "events.h"
+
+const char* const REFUSAL_TEXT[] = {
+    "You don't own this property!",
+    "This property is already mortgaged!",
+    "You must sell all houses first!",
+    "This property is not mortgaged!",
+    "You don't have enough money to unmortgage this property!",
+    "Can only build houses on regular properties!",
+    "You need to own all properties of this color to build houses!",
+    "Already has a hotel! Cannot build more.",
+    "Not enough money to build a house!",
+    "Must build evenly across properties of the same color!",
+    "No houses to sell!",
+    "Must sell houses evenly across properties of the same color!",
+    "Not enough money to purchase this property.",
+    "Not enough money to pay fine!",
+    "No Get Out of Jail Free cards!",
+    "Can't build while any property of this color is mortgaged!"
+};
+
+const char* const JAIL_EXIT_TEXT[] = {
+    "",
+    "Paid fine. You're out of jail!",
+    "Used Get Out of Jail Free card!",
+    "Rolled doubles! You're out of jail!",
+    "Third turn in jail. Paid the fine."
+};
+
+// Formats one event. Lines end in '\n' rather than endl: output stays in
+// the stream buffer until it fills or the console next reads input (cout is
+// tied to cin), instead of costing a flush per line.
+void writeEvent(const GameState* game, const GameEvent* event) {
+    const char* name = playerName(game, event->player);
+    const char* square = game->board->squares[event->square].name;
+    
+    switch (event->type) {
+        case EVENT_ROLL:
+            cout << "\nRolled: " << event->amount << " and " << event->value << '\n';
+            break;
+        case EVENT_PASS_GO:
+            cout << name << " passed GO! Collect $" << game->board->goSalary << '\n';
+            break;
+        case EVENT_LAND:
+            cout << name << " landed on " << square << '\n';
+            break;
+        case EVENT_PURCHASE:
+            cout << name << " bought " << square << " for $" << event->amount << '\n';
+            break;
+        case EVENT_RENT:
+            cout << name << " paid $" << event->amount << " in rent to " << playerName(game, event->value) << '\n';
+            break;
+        case EVENT_TAX:
+            cout << name << " paid $" << event->amount << " in " << square << '\n';
+            break;
+        case EVENT_CARD:
+            cout << '\n' << (event->value == CHANCE_DECK ? "Chance" : "Community Chest") << " Card: "
+                 << game->board->cards[event->value][event->amount].text << '\n';
+            break;
+        case EVENT_CARD_MOVE:
+            cout << "Moved to " << square << '\n';
+            break;
+        case EVENT_CARD_MONEY:
+            if (event->amount > 0) {
+                cout << "Collected $" << event->amount << '\n';
+            } else {
+                cout << "Paid $" << -event->amount << '\n';
+            }
+            break;
+        case EVENT_JAIL_CARD_RECEIVED:
+            cout << "Received Get Out of Jail Free card\n";
+            break;
+        case EVENT_SENT_TO_JAIL:
+            cout << name << " was sent to Jail!\n";
+            break;
+        case EVENT_LEFT_JAIL:
+            cout << JAIL_EXIT_TEXT[event->value] << '\n';
+            break;
+        case EVENT_MORTGAGE:
+            cout << name << " mortgaged " << square << ". Received $" << event->amount << '\n';
+            break;
+        case EVENT_UNMORTGAGE:
+            cout << name << " unmortgaged " << square << ". Paid $" << event->amount << '\n';
+            break;
+        case EVENT_BUILD:
+            if (event->value == HOTEL) {
+                cout << name << " built a hotel on " << square << '\n';
+            } else {
+                cout << name << " built house #" << event->value << " on " << square << '\n';
+            }
+            break;
+        case EVENT_SELL_HOUSE:
+            if (event->value == MAX_HOUSES) {
+                cout << name << " sold the hotel on " << square << " back to houses";
+            } else {
+                cout << name << " sold a house on " << square;
+            }
+            cout << ". Received $" << event->amount << '\n';
+            break;
+        case EVENT_TRADE:
+            cout << name << " traded with " << playerName(game, event->value) << '\n';
+            break;
+        case EVENT_BANKRUPT:
+            cout << name << " has gone bankrupt!\n";
+            break;
+        case EVENT_GAME_OVER:
+            cout << "\nGame Over! " << name << " wins!\n";
+            break;
+        case EVENT_REFUSED:
+            cout << REFUSAL_TEXT[event->value] << '\n';
+            break;
+    }
+}
+
+// "silent", "summary" or "verbose"; -1 if it's none of them
+int parseOutputLevel(const char* text) {
+    if (strcmp(text, "silent") == 0) return OUTPUT_SILENT;
+    if (strcmp(text, "summary") == 0) return OUTPUT_SUMMARY;
+    if (strcmp(text, "verbose") == 0) return OUTPUT_VERBOSE;
+    return -1;
+}
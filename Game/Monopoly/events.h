@@ -0,0 +1,101 @@
+#ifndef EVENTS_H
+#define EVENTS_H
+
+#include "monopoly.h"
+
+// Game events are reported as typed records and only formatted if the
+// game's output level asks for them, so silent games pay one comparison
+// per event and nothing else.
+
+// Event types
+const int EVENT_ROLL = 0;               // amount = die 1, value = die 2
+const int EVENT_PASS_GO = 1;
+const int EVENT_LAND = 2;               // square
+const int EVENT_PURCHASE = 3;           // square, amount = price
+const int EVENT_RENT = 4;               // square, amount, value = owner
+const int EVENT_TAX = 5;                // square, amount
+const int EVENT_CARD = 6;               // value = deck, amount = card number
+const int EVENT_CARD_MOVE = 7;          // square
+const int EVENT_CARD_MONEY = 8;         // amount (negative when paying)
+const int EVENT_JAIL_CARD_RECEIVED = 9;
+const int EVENT_SENT_TO_JAIL = 10;
+const int EVENT_LEFT_JAIL = 11;         // amount = turns in jail, value = JAIL_EXIT_*
+const int EVENT_MORTGAGE = 12;          // square, amount received
+const int EVENT_UNMORTGAGE = 13;        // square, amount paid
+const int EVENT_BUILD = 14;             // square, value = houses after
+const int EVENT_SELL_HOUSE = 15;        // square, value = houses after, amount received
+const int EVENT_TRADE = 16;             // value = other player
+const int EVENT_BANKRUPT = 17;
+const int EVENT_GAME_OVER = 18;         // player = winner
+const int EVENT_REFUSED = 19;           // value = REFUSED_*
+const int NUM_EVENT_TYPES = 20;
+
+// Lowest output level that shows each event type
+const unsigned char EVENT_LEVELS[NUM_EVENT_TYPES] = {
+    OUTPUT_VERBOSE, OUTPUT_VERBOSE, OUTPUT_VERBOSE, OUTPUT_SUMMARY, OUTPUT_SUMMARY,
+    OUTPUT_SUMMARY, OUTPUT_VERBOSE, OUTPUT_VERBOSE, OUTPUT_VERBOSE, OUTPUT_VERBOSE,
+    OUTPUT_VERBOSE, OUTPUT_VERBOSE, OUTPUT_SUMMARY, OUTPUT_SUMMARY, OUTPUT_SUMMARY,
+    OUTPUT_SUMMARY, OUTPUT_SUMMARY, OUTPUT_SUMMARY, OUTPUT_SUMMARY, OUTPUT_VERBOSE
+};
+
+// Event types recordStats counts; the rest never reach it
+const unsigned int STATS_EVENTS =
+    (1u << EVENT_PASS_GO) | (1u << EVENT_LAND) | (1u << EVENT_RENT) | (1u << EVENT_TAX) |
+    (1u << EVENT_CARD_MOVE) | (1u << EVENT_CARD_MONEY) | (1u << EVENT_SENT_TO_JAIL) |
+    (1u << EVENT_LEFT_JAIL) | (1u << EVENT_BANKRUPT);
+
+// How a player got out of jail (same numbers as chooseJailOption)
+const int JAIL_EXIT_FINE = 1;
+const int JAIL_EXIT_CARD = 2;
+const int JAIL_EXIT_DOUBLES = 3;
+const int JAIL_EXIT_THIRD_TURN = 4;
+
+// Why an action was refused
+const int REFUSED_NOT_OWNER = 0;
+const int REFUSED_ALREADY_MORTGAGED = 1;
+const int REFUSED_HAS_HOUSES = 2;
+const int REFUSED_NOT_MORTGAGED = 3;
+const int REFUSED_CANNOT_AFFORD_UNMORTGAGE = 4;
+const int REFUSED_NOT_BUILDABLE = 5;
+const int REFUSED_NO_MONOPOLY = 6;
+const int REFUSED_HAS_HOTEL = 7;
+const int REFUSED_CANNOT_AFFORD_HOUSE = 8;
+const int REFUSED_UNEVEN_BUILD = 9;
+const int REFUSED_NO_HOUSES = 10;
+const int REFUSED_UNEVEN_SALE = 11;
+const int REFUSED_CANNOT_AFFORD_PROPERTY = 12;
+const int REFUSED_CANNOT_AFFORD_FINE = 13;
+const int REFUSED_NO_JAIL_CARD = 14;
+const int REFUSED_MORTGAGED_GROUP = 15;
+
+struct GameEvent {
+    int type;
+    int player;
+    int square;
+    int amount;
+    int value;
+};
+
+// Function declarations
+void writeEvent(const GameState*, const GameEvent*);
+int parseOutputLevel(const char*);
+void recordStats(const GameState*, const GameEvent*); // see stats.h
+
+inline void emitEvent(const GameState* game, int type, int player, int square = 0, int amount = 0, int value = 0) {
+    bool counted = game->stats && (STATS_EVENTS & (1u << type));
+    if (game->outputLevel >= EVENT_LEVELS[type] || counted) {
+        GameEvent event = {type, player, square, amount, value};
+        if (game->outputLevel >= EVENT_LEVELS[type]) {
+            writeEvent(game, &event);
+        }
+        if (counted) {
+            recordStats(game, &event);
+        }
+    }
+}
+
+inline void emitRefusal(const GameState* game, int reason) {
+    emitEvent(game, EVENT_REFUSED, game->currentPlayer, 0, 0, reason);
+}
+
+#endif
@@ -0,0 +1,65 @@
+#include "fork.h"
+
+static int chunkLength(int chunk) {
+    int rest = static_cast<int>(sizeof(GameState)) - chunk * FORK_CHUNK_SIZE;
+    return rest < FORK_CHUNK_SIZE ? rest : FORK_CHUNK_SIZE;
+}
+
+// Makes a fork of game under parent (0 for a root, which copies every
+// chunk). The caller holds the one reference to it.
+GameFork* forkGame(const GameState* game, GameFork* parent) {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(game);
+    bool changed[FORK_CHUNKS];
+    int changedCount = 0;
+    for (int i = 0; i < FORK_CHUNKS; i++) {
+        changed[i] = parent == 0 ||
+                     memcmp(parent->chunks[i], bytes + i * FORK_CHUNK_SIZE, chunkLength(i)) != 0;
+        if (changed[i]) {
+            changedCount++;
+        }
+    }
+    
+    GameFork* fork = new GameFork;
+    fork->parent = parent;
+    fork->references = 1;
+    fork->ownedChunks = changedCount;
+    fork->data = changedCount > 0 ? new unsigned char[changedCount * FORK_CHUNK_SIZE] : 0;
+    unsigned char* next = fork->data;
+    for (int i = 0; i < FORK_CHUNKS; i++) {
+        if (changed[i]) {
+            memcpy(next, bytes + i * FORK_CHUNK_SIZE, chunkLength(i));
+            fork->chunks[i] = next;
+            next += FORK_CHUNK_SIZE;
+        } else {
+            fork->chunks[i] = parent->chunks[i];
+        }
+    }
+    if (parent) {
+        parent->references++;
+    }
+    return fork;
+}
+
+// Copies the forked state into game. Journal, undo log, replay and stats
+// pointers come back as they were when the fork was made.
+void restoreFork(const GameFork* fork, GameState* game) {
+    unsigned char* bytes = reinterpret_cast<unsigned char*>(game);
+    for (int i = 0; i < FORK_CHUNKS; i++) {
+        memcpy(bytes + i * FORK_CHUNK_SIZE, fork->chunks[i], chunkLength(i));
+    }
+}
+
+// Drops a reference, freeing the fork and any ancestors nothing else uses
+void releaseFork(GameFork* fork) {
+    while (fork != 0 && --fork->references == 0) {
+        GameFork* parent = fork->parent;
+        delete[] fork->data;
+        delete fork;
+        fork = parent;
+    }
+}
+
+// Memory the fork itself takes, not counting what it shares
+int forkBytes(const GameFork* fork) {
+    return static_cast<int>(sizeof(GameFork)) + fork->ownedChunks * FORK_CHUNK_SIZE;
+}
@@ -0,0 +1,41 @@
+#ifndef FORK_H
+#define FORK_H
+
+#include "monopoly.h"
+#include <atomic>
+
+// Copy-on-write snapshots of a game for what-if analysis. A fork records
+// a GameState as a child of an earlier fork: the state is cut into
+// FORK_CHUNK_SIZE-byte chunks, and the child copies only the chunks that
+// differ from its parent, pointing at the parent's for the rest. Board
+// data, card texts and names are shared by pointer as in any GameState,
+// so branches off one position cost memory in proportion to how far they
+// have moved from it.
+//
+//   GameFork* root = forkGame(&game, 0);
+//   ... change game ...
+//   GameFork* branch = forkGame(&game, root);
+//   restoreFork(branch, &copy); // from any thread, any number of times
+//   releaseFork(branch);
+//   releaseFork(root);
+//
+// Forks never change once made, so threads can restore the same ones at
+// once. A fork keeps its parent alive until it is released itself.
+const int FORK_CHUNK_SIZE = 64;
+const int FORK_CHUNKS = (sizeof(GameState) + FORK_CHUNK_SIZE - 1) / FORK_CHUNK_SIZE;
+
+struct GameFork {
+    GameFork* parent;
+    atomic<int> references;
+    int ownedChunks;
+    unsigned char* data;                      // this fork's own chunks
+    const unsigned char* chunks[FORK_CHUNKS]; // in data or an ancestor's
+};
+
+// Function declarations
+GameFork* forkGame(const GameState*, GameFork*);
+void restoreFork(const GameFork*, GameState*);
+void releaseFork(GameFork*);
+int forkBytes(const GameFork*);
+
+#endif
@@ -0,0 +1,254 @@
+#include "journal.h"
+#include "savefile.h"
+#include <cstdio>
+#include <vector>
+
+void encodeRecord(const JournalRecord* record, unsigned char bytes[]) {
+    bytes[0] = record->type;
+    bytes[1] = record->player;
+    bytes[2] = record->square;
+    bytes[3] = record->value;
+    unsigned int amount = static_cast<unsigned int>(record->amount);
+    for (int i = 0; i < 4; i++) {
+        bytes[4 + i] = (amount >> (8 * i)) & 0xFF;
+    }
+}
+
+void decodeRecord(const unsigned char bytes[], JournalRecord* record) {
+    record->type = bytes[0];
+    record->player = bytes[1];
+    record->square = bytes[2];
+    record->value = bytes[3];
+    unsigned int amount = 0;
+    for (int i = 0; i < 4; i++) {
+        amount |= static_cast<unsigned int>(bytes[4 + i]) << (8 * i);
+    }
+    record->amount = static_cast<int>(amount);
+}
+
+static void flushJournal(Journal* journal) {
+    journal->file.write(reinterpret_cast<const char*>(journal->pending), journal->pendingLength);
+    journal->file.flush();
+    journal->pendingLength = 0;
+}
+
+// Starts a new journal file holding just a checkpoint of the current state.
+// It is written beside the old journal and renamed over it, so there is
+// always one complete journal on disk.
+static bool writeCheckpoint(Journal* journal, const GameState* game) {
+    unsigned char bytes[JOURNAL_RECORD_SIZE + MAX_SAVE_SIZE];
+    int length = encodeGame(game, bytes + JOURNAL_RECORD_SIZE, MAX_SAVE_SIZE);
+    if (length == 0) {
+        return false;
+    }
+    JournalRecord header = {JOURNAL_CHECKPOINT, 0, 0, 0, length};
+    encodeRecord(&header, bytes);
+    
+    if (journal->file.is_open()) {
+        journal->file.close();
+    }
+    ofstream tempFile(JOURNAL_TEMP_FILE, ios::binary | ios::trunc);
+    tempFile.write(reinterpret_cast<const char*>(bytes), JOURNAL_RECORD_SIZE + length);
+    tempFile.close();
+    if (!tempFile || rename(JOURNAL_TEMP_FILE, JOURNAL_FILE) != 0) {
+        return false;
+    }
+    
+    journal->file.open(JOURNAL_FILE, ios::binary | ios::app);
+    journal->turnsSinceCheckpoint = 0;
+    return journal->file.is_open();
+}
+
+// Must be called at a turn boundary
+bool openJournal(Journal* journal, GameState* game) {
+    journal->pendingLength = 0;
+    game->journal = 0;
+    if (!writeCheckpoint(journal, game)) {
+        cout << "Warning: could not create the game journal. Crash recovery is off.\n";
+        return false;
+    }
+    game->journal = journal;
+    return true;
+}
+
+// Clean shutdown: the journal is only needed to recover from a crash
+void closeJournal(Journal* journal, GameState* game) {
+    if (game->journal != journal) {
+        return;
+    }
+    journal->file.close();
+    remove(JOURNAL_FILE);
+    game->journal = 0;
+}
+
+void appendJournal(Journal* journal, const JournalRecord* record) {
+    if (journal->pendingLength + JOURNAL_RECORD_SIZE > JOURNAL_BUFFER_SIZE) {
+        flushJournal(journal);
+    }
+    encodeRecord(record, journal->pending + journal->pendingLength);
+    journal->pendingLength += JOURNAL_RECORD_SIZE;
+}
+
+// Marks the end of a turn: writes out the turn's records and checkpoints
+// every JOURNAL_CHECKPOINT_TURNS turns
+void commitJournalTurn(GameState* game) {
+    Journal* journal = game->journal;
+    if (!journal) {
+        return;
+    }
+    
+    journalEvent(game, JOURNAL_TURN, 0, 0, game->currentPlayer, 0);
+    flushJournal(journal);
+    
+    if (++journal->turnsSinceCheckpoint >= JOURNAL_CHECKPOINT_TURNS && !writeCheckpoint(journal, game)) {
+        cout << "Warning: could not checkpoint the game journal. Crash recovery is off.\n";
+        journal->file.close();
+        game->journal = 0;
+    }
+}
+
+// The trade a TRADE record describes. Only the net money is journaled,
+// so it all goes one way.
+TradeOffer tradeFromRecord(const JournalRecord* record) {
+    TradeOffer offer;
+    offer.fromPlayer = record->player & 0x0F;
+    offer.toPlayer = record->player >> 4;
+    offer.offeredProperty = record->square == 0xFF ? -1 : record->square;
+    offer.requestedProperty = record->value == 0xFF ? -1 : record->value;
+    offer.offeredMoney = record->amount > 0 ? record->amount : 0;
+    offer.requestedMoney = record->amount < 0 ? -record->amount : 0;
+    return offer;
+}
+
+static bool isValidSquare(const GameState* game, int square) {
+    return square < game->board->size;
+}
+
+// Applies one record with the same state changes the engine made when it
+// was written. Returns false if the record doesn't fit the game.
+static bool applyRecord(GameState* game, const Property board[], const JournalRecord* record) {
+    int playerNum = record->player;
+    Player* player = &game->players[playerNum < MAX_PLAYERS ? playerNum : 0];
+    int square = record->square;
+    
+    if (record->type != JOURNAL_TRADE && playerNum >= game->numPlayers) {
+        return false;
+    }
+    
+    switch (record->type) {
+        case JOURNAL_ROLL:
+            // Consuming the pair keeps the dice in step with the original game
+            return nextDicePair(&game->dice) == record->value;
+            
+        case JOURNAL_MOVE:
+            if (!isValidSquare(game, square)) return false;
+            player->money += record->amount;
+            player->position = square;
+            return true;
+            
+        case JOURNAL_PAYMENT:
+            player->money += record->amount;
+            return true;
+            
+        case JOURNAL_PURCHASE:
+            if (!isValidSquare(game, square) || game->squares[square].owner != -1) return false;
+            player->money -= record->amount;
+            setPropertyOwner(game, board, square, playerNum);
+            return true;
+            
+        case JOURNAL_RENT:
+            if (record->value >= game->numPlayers) return false;
+            player->money -= record->amount;
+            game->players[record->value].money += record->amount;
+            return true;
+            
+        case JOURNAL_CARD:
+            if (square >= NUM_DECKS || record->value >= DECK_SIZE) return false;
+            game->deckIndex[square] = (record->value + 1) % DECK_SIZE;
+            return true;
+            
+        case JOURNAL_JAIL:
+            player->inJail = square != 0;
+            player->jailTurns = record->value;
+            player->getOutOfJailCards = record->amount;
+            return true;
+            
+        case JOURNAL_BUILD:
+            if (!isValidSquare(game, square) || record->value > HOTEL) return false;
+            setHouses(game, square, record->value);
+            player->money += record->amount;
+            return true;
+            
+        case JOURNAL_MORTGAGE:
+            if (!isValidSquare(game, square)) return false;
+            setMortgaged(game, square, record->value != 0);
+            player->money += record->amount;
+            return true;
+            
+        case JOURNAL_TRADE: {
+            TradeOffer offer = tradeFromRecord(record);
+            return offer.fromPlayer < game->numPlayers && offer.toPlayer < game->numPlayers &&
+                   executeTrade(game, board, &offer);
+        }
+            
+        case JOURNAL_BANKRUPT:
+            returnPropertiesToBank(game, board, playerNum);
+            return true;
+            
+        case JOURNAL_TURN:
+            if (record->value >= game->numPlayers) return false;
+            game->currentPlayer = record->value;
+            return true;
+    }
+    return false;
+}
+
+// Rebuilds the game an unclean shutdown left behind: the checkpoint, then
+// every complete turn after it. Returns false if there is nothing to recover.
+bool recoverJournal(GameState* game, PlayerNames* names) {
+    ifstream inFile(JOURNAL_FILE, ios::binary);
+    if (!inFile) {
+        return false;
+    }
+    vector<unsigned char> data((istreambuf_iterator<char>(inFile)), istreambuf_iterator<char>());
+    inFile.close();
+    
+    JournalRecord header;
+    if (data.size() < static_cast<size_t>(JOURNAL_RECORD_SIZE)) {
+        return false;
+    }
+    decodeRecord(data.data(), &header);
+    size_t offset = JOURNAL_RECORD_SIZE + header.amount;
+    if (header.type != JOURNAL_CHECKPOINT || header.amount <= 0 || header.amount > MAX_SAVE_SIZE ||
+        offset > data.size()) {
+        return false;
+    }
+    
+    GameState working = *game;
+    working.journal = 0;
+    if (decodeGame(data.data() + JOURNAL_RECORD_SIZE, header.amount, &working, names) != SAVE_OK) {
+        return false;
+    }
+    const Property* board = working.board->squares;
+    rebuildOwnershipIndex(&working, board);
+    
+    GameState committed = working;
+    int turns = 0;
+    for (; offset + JOURNAL_RECORD_SIZE <= data.size(); offset += JOURNAL_RECORD_SIZE) {
+        JournalRecord record;
+        decodeRecord(data.data() + offset, &record);
+        if (!applyRecord(&working, board, &record)) {
+            break;
+        }
+        if (record.type == JOURNAL_TURN) {
+            committed = working;
+            turns++;
+        }
+    }
+    
+    *game = committed;
+    game->gameOver = false;
+    assignConsoleControllers(game);
+    cout << "Recovered an interrupted game (" << turns << " turns replayed since the last checkpoint).\n";
+    return true;
+}
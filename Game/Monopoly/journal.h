@@ -0,0 +1,101 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include "monopoly.h"
+
+// The journal file starts with a checkpoint (an encoded save) followed by
+// one fixed-size record per game event. It only exists while a console
+// game is running: a journal found at startup means the last game didn't
+// shut down cleanly, and it can be resumed from there.
+const char* const JOURNAL_FILE = "monopoly_journal.dat";
+const char* const JOURNAL_TEMP_FILE = "monopoly_journal.tmp";
+const int JOURNAL_CHECKPOINT_TURNS = 20;
+const int JOURNAL_BUFFER_SIZE = 512;
+
+// Record types. Field use:
+//   ROLL        player, value = dice pair as (die1 << 4) | die2
+//   MOVE        player, square = new position, amount = GO salary collected
+//   PAYMENT     player, amount = money received (negative when paying)
+//   PURCHASE    player, square, amount = price
+//   RENT        player = payer, value = owner, square, amount
+//   CARD        player, square = deck (0 Chance, 1 Community Chest), value = slot drawn
+//   JAIL        player, square = in jail, value = turns in jail, amount = jail cards held
+//   BUILD       player, square, value = houses after, amount = money received
+//   MORTGAGE    player, square, value = mortgaged after, amount = money received
+//   TRADE       player = from | (to << 4), square/value = offered/requested
+//               holdings slot (0xFF for none), amount = net money from -> to
+//   BANKRUPT    player
+//   TURN        value = next player. Records after the last TURN are an
+//               unfinished turn and are not replayed.
+//   CHECKPOINT  amount = length of the encoded save that follows
+const int JOURNAL_ROLL = 1;
+const int JOURNAL_MOVE = 2;
+const int JOURNAL_PAYMENT = 3;
+const int JOURNAL_PURCHASE = 4;
+const int JOURNAL_RENT = 5;
+const int JOURNAL_CARD = 6;
+const int JOURNAL_JAIL = 7;
+const int JOURNAL_BUILD = 8;
+const int JOURNAL_MORTGAGE = 9;
+const int JOURNAL_TRADE = 10;
+const int JOURNAL_BANKRUPT = 11;
+const int JOURNAL_TURN = 12;
+const int JOURNAL_CHECKPOINT = 13;
+
+const int JOURNAL_RECORD_SIZE = 8;
+
+struct JournalRecord {
+    unsigned char type;
+    unsigned char player;
+    unsigned char square;
+    unsigned char value;
+    int amount;
+};
+
+// Records are buffered and written once per turn, so a crash loses at most
+// the turn in progress
+struct Journal {
+    ofstream file;
+    unsigned char pending[JOURNAL_BUFFER_SIZE];
+    int pendingLength;
+    int turnsSinceCheckpoint;
+};
+
+// Function declarations
+bool openJournal(Journal*, GameState*);
+void closeJournal(Journal*, GameState*);
+void appendJournal(Journal*, const JournalRecord*);
+void commitJournalTurn(GameState*);
+bool recoverJournal(GameState*, PlayerNames*);
+void encodeRecord(const JournalRecord*, unsigned char[]);
+void decodeRecord(const unsigned char[], JournalRecord*);
+TradeOffer tradeFromRecord(const JournalRecord*);
+void recordUndo(GameState*, const JournalRecord*);         // see undo.h
+void recordReplayAction(GameState*, const JournalRecord*); // see replay.h
+
+// Called from every mutation site; a no-op for games with no journal,
+// undo log or replay
+inline void journalEvent(GameState* game, int type, int player, int square, int value, int amount) {
+    if (game->journal || game->undo || game->replay) {
+        JournalRecord record = {
+            static_cast<unsigned char>(type), static_cast<unsigned char>(player),
+            static_cast<unsigned char>(square), static_cast<unsigned char>(value), amount
+        };
+        if (game->journal) {
+            appendJournal(game->journal, &record);
+        }
+        if (game->undo) {
+            recordUndo(game, &record);
+        }
+        if (game->replay) {
+            recordReplayAction(game, &record);
+        }
+    }
+}
+
+inline void journalJail(GameState* game, int playerNum) {
+    const Player* player = &game->players[playerNum];
+    journalEvent(game, JOURNAL_JAIL, playerNum, player->inJail, player->jailTurns, player->getOutOfJailCards);
+}
+
+#endif
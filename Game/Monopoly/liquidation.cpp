@@ -0,0 +1,401 @@
+#include "liquidation.h"
+#include <algorithm>
+#include <climits>
+
+// One way of settling a choice: sell the group down to level (see
+// addSaleOptions), then mortgage
+struct LiquidationOption {
+    int cash;
+    int loss;
+    int units; // cash in knapsack units, up to the target
+    int level;
+    SquareMask lowered;
+    SquareMask mortgages;
+};
+
+// A developed color group or a few bare squares, with its options
+struct LiquidationChoice {
+    SquareMask group; // 0 for bare squares
+    int firstOption;
+    int options; // richest first
+};
+
+// Every choice's options, the one being added last
+struct LiquidationOptions {
+    LiquidationOption option[MAX_LIQUIDATION_OPTIONS];
+    int count;
+    int first; // the choice being added starts here
+    int debt;
+};
+
+static int greatestCommonDivisor(int a, int b) {
+    while (b != 0) {
+        int rest = a % b;
+        a = b;
+        b = rest;
+    }
+    return a;
+}
+
+// Houses a square is left with: levels above it don't touch it, and it is
+// sold down to the level, or one below if it is in lowered
+static int targetHouses(int houses, int level, SquareMask lowered, int square) {
+    if (houses < level) {
+        return houses;
+    }
+    return (lowered & squareBit(square)) ? level - 1 : level;
+}
+
+// Drops the options of the choice being added that another beats by
+// raising as much for no more loss, counting anything over the debt as
+// just the debt. The rest are left richest first.
+static void pruneOptions(LiquidationOptions* list) {
+    int debt = list->debt;
+    sort(list->option + list->first, list->option + list->count,
+         [debt](const LiquidationOption& a, const LiquidationOption& b) {
+        int cashA = a.cash < debt ? a.cash : debt;
+        int cashB = b.cash < debt ? b.cash : debt;
+        return cashA != cashB ? cashA > cashB : a.loss < b.loss;
+    });
+    int kept = list->first;
+    int leastLoss = INT_MAX;
+    for (int o = list->first; o < list->count; o++) {
+        if (list->option[o].loss < leastLoss) {
+            leastLoss = list->option[o].loss;
+            list->option[kept++] = list->option[o];
+        }
+    }
+    list->count = kept;
+}
+
+// Options are added richest first, so when the buffer is full and pruning
+// makes no room, the ones dropped are never a choice's richest
+static void addOption(LiquidationOptions* list, const LiquidationOption& option) {
+    if (list->count == MAX_LIQUIDATION_OPTIONS) {
+        pruneOptions(list);
+        if (list->count == MAX_LIQUIDATION_OPTIONS) {
+            return;
+        }
+    }
+    list->option[list->count++] = option;
+}
+
+// Adds an option for each way of mortgaging bare squares, on top of sales
+// that raised cash and lost loss. All of them first, none of them last.
+static void addMortgageOptions(LiquidationOptions* list, const Property board[],
+                               int cash, int loss, int level, SquareMask lowered, SquareMask bare) {
+    bool everySubset = countSquares(bare) <= MAX_LIQUIDATION_SUBSET_SQUARES;
+    SquareMask subset = bare;
+    for (;;) {
+        LiquidationOption option = {cash, loss, 0, level, lowered, subset};
+        for (SquareMask rest = subset; rest != 0; rest &= rest - 1) {
+            const Property* property = &board[__builtin_ctzll(rest)];
+            option.cash += property->mortgageValue;
+            option.loss += property->unmortgageCost - property->mortgageValue;
+        }
+        addOption(list, option);
+        if (subset == 0) {
+            break;
+        }
+        subset = everySubset ? (subset - 1) & bare : 0; // next subset, counting down
+    }
+}
+
+// Adds the options of a developed group. Even selling only ever takes a
+// house off a square with the most, so after any sales there is a level
+// that every square sold from is at, or one below, and that no square is
+// above. Each level from the highest square another player owns up to
+// the group's top gives a set of reachable states: every one of our
+// squares at or above the level ends at the level or one below it. The
+// lowest level, with every square lowered, sells the most, so it goes
+// first; each level's options are pruned as they are added.
+static void addSaleOptions(LiquidationOptions* list, const GameState* game, const Property board[],
+                           SquareMask group, SquareMask owned) {
+    int top = 0;
+    int floor = 0;
+    for (SquareMask rest = group; rest != 0; rest &= rest - 1) {
+        int square = __builtin_ctzll(rest);
+        int houses = game->squares[square].houses;
+        if (!(owned & squareBit(square))) {
+            floor = houses > floor ? houses : floor;
+        } else if (houses > top) {
+            top = houses;
+        }
+    }
+    
+    if (top < floor) {
+        top = floor; // another player has the most, so nothing of ours sells
+    }
+    
+    for (int level = floor; level <= top; level++) {
+        // Squares that can end at the level or one below; larger groups
+        // only try lowering them in board order
+        SquareMask flexible = 0;
+        for (SquareMask rest = group & owned; rest != 0; rest &= rest - 1) {
+            int square = __builtin_ctzll(rest);
+            if (level > 0 && game->squares[square].houses >= level) {
+                flexible |= squareBit(square);
+            }
+        }
+        bool everySubset = countSquares(flexible) <= MAX_LIQUIDATION_SUBSET_SQUARES;
+        SquareMask lowered = flexible;
+        for (;;) {
+            int cash = 0;
+            int loss = 0;
+            SquareMask bare = 0;
+            for (SquareMask rest = group & owned; rest != 0; rest &= rest - 1) {
+                int square = __builtin_ctzll(rest);
+                int houses = game->squares[square].houses;
+                int sold = houses - targetHouses(houses, level, lowered, square);
+                cash += sold * (board[square].houseCost / 2);
+                loss += sold * (board[square].houseCost - board[square].houseCost / 2);
+                if (houses == sold && !game->squares[square].mortgaged) {
+                    bare |= squareBit(square);
+                }
+            }
+            addMortgageOptions(list, board, cash, loss, level, lowered, bare);
+            
+            if (lowered == 0) {
+                break;
+            }
+            if (everySubset) {
+                lowered = (lowered - 1) & flexible; // next subset, counting down
+            } else {
+                lowered &= ~(1ULL << (63 - __builtin_clzll(lowered)));
+            }
+        }
+        pruneOptions(list);
+    }
+}
+
+// Starts a choice; endChoice prunes its options and records it
+static LiquidationChoice startChoice(LiquidationOptions* list, SquareMask group) {
+    list->first = list->count;
+    LiquidationChoice choice = {group, list->count, 0};
+    return choice;
+}
+
+static void endChoice(LiquidationOptions* list, LiquidationChoice* choice) {
+    pruneOptions(list);
+    choice->options = list->count - choice->firstOption;
+}
+
+// Finds the cheapest way for the current player to raise debt dollars.
+// Returns false, with no steps, if selling and mortgaging everything
+// wouldn't be enough.
+bool planLiquidation(const GameState* game, const Property board[], int debt, LiquidationPlan* plan) {
+    plan->cash = 0;
+    plan->loss = 0;
+    plan->steps = 0;
+    if (debt <= 0) {
+        return true;
+    }
+    
+    // Most calls are for debts nothing would cover; every house sold and
+    // every square mortgaged is more than any plan can raise
+    SquareMask owned = game->ownedMasks[game->currentPlayer];
+    int most = 0;
+    for (SquareMask rest = owned; rest != 0; rest &= rest - 1) {
+        int square = __builtin_ctzll(rest);
+        most += game->squares[square].houses * (board[square].houseCost / 2);
+        if (!game->squares[square].mortgaged) {
+            most += board[square].mortgageValue;
+        }
+    }
+    if (most < debt) {
+        return false;
+    }
+    
+    // The choices come from the board's groups and the ownership index
+    const Board* layout = game->board;
+    SquareMask kinds[NUM_COLORS + 3];
+    SquareMask covered = layout->railroadMask | layout->utilityMask;
+    for (int color = 0; color < NUM_COLORS; color++) {
+        kinds[color] = layout->colorMasks[color];
+        covered |= layout->colorMasks[color];
+    }
+    kinds[NUM_COLORS] = layout->railroadMask;
+    kinds[NUM_COLORS + 1] = layout->utilityMask;
+    kinds[NUM_COLORS + 2] = ~covered;
+    
+    LiquidationOptions list;
+    list.count = 0;
+    list.debt = debt;
+    LiquidationChoice choices[MAX_LIQUIDATION_CHOICES];
+    int numChoices = 0;
+    int available = 0; // with everything sold and mortgaged
+    for (int kind = 0; kind < NUM_COLORS + 3; kind++) {
+        SquareMask group = kinds[kind];
+        if ((group & owned) == 0) {
+            continue;
+        }
+        if (kind < NUM_COLORS && (group & owned & game->houseMasks[0]) != 0) {
+            LiquidationChoice choice = startChoice(&list, group);
+            addSaleOptions(&list, game, board, group, owned);
+            endChoice(&list, &choice);
+            available += list.option[choice.firstOption].cash;
+            choices[numChoices++] = choice;
+            continue;
+        }
+        
+        // A few bare squares at a time: mortgage any of them
+        SquareMask bare = group & owned & ~game->mortgagedMask;
+        while (bare != 0) {
+            SquareMask few = 0;
+            for (int i = 0; i < MAX_LIQUIDATION_SUBSET_SQUARES && bare != 0; i++) {
+                few |= bare & (0 - bare);
+                bare &= bare - 1;
+            }
+            LiquidationChoice choice = startChoice(&list, 0);
+            addMortgageOptions(&list, board, 0, 0, 0, 0, few);
+            endChoice(&list, &choice);
+            available += list.option[choice.firstOption].cash;
+            choices[numChoices++] = choice;
+        }
+    }
+    if (available < debt) {
+        return false;
+    }
+    LiquidationOption* options = list.option;
+    
+    // Money is counted in units that divide every option's cash, so the
+    // standard board's multiples of $5 keep the knapsack small. If the debt
+    // is still too many units, units are made coarser and option cash
+    // rounded down, which can only overstate what a plan needs.
+    int unit = 0;
+    for (int o = 0; o < list.count; o++) {
+        unit = greatestCommonDivisor(unit, options[o].cash);
+    }
+    int target = (debt + unit - 1) / unit;
+    if (target > MAX_LIQUIDATION_STATES) {
+        unit = (debt + MAX_LIQUIDATION_STATES - 1) / MAX_LIQUIDATION_STATES;
+        target = (debt + unit - 1) / unit;
+    }
+    
+    for (int o = 0; o < list.count; o++) {
+        options[o].units = options[o].cash / unit < target ? options[o].cash / unit : target;
+    }
+    
+    // Richest choices first, so the ones left at the end can raise little
+    // and only states near the target can still reach it
+    sort(choices, choices + numChoices, [options](const LiquidationChoice& a, const LiquidationChoice& b) {
+        return options[a.firstOption].units > options[b.firstOption].units;
+    });
+    int left[MAX_LIQUIDATION_CHOICES + 1]; // units choices c on can raise
+    left[numChoices] = 0;
+    for (int c = numChoices - 1; c >= 0; c--) {
+        left[c] = left[c + 1] + options[choices[c].firstOption].units;
+    }
+    
+    // best[s]: least loss raising s units, with target standing for target
+    // or more, for s up to the most the choices so far can raise and down
+    // to the least the rest can still take to the target. Each choice
+    // records the option each state came from; the state before is s less
+    // that option's units, except for the target, whose state before is
+    // kept on its own.
+    int reach = 0;
+    int bestLoss[2][MAX_LIQUIDATION_STATES + 1];
+    int* best = bestLoss[0];
+    int* next = bestLoss[1];
+    unsigned short chosen[MAX_LIQUIDATION_CHOICES][MAX_LIQUIDATION_STATES + 1];
+    int fromTarget[MAX_LIQUIDATION_CHOICES];
+    best[0] = 0;
+    for (int c = 0; c < numChoices; c++) {
+        const LiquidationChoice* choice = &choices[c];
+        int nextReach = reach + options[choice->firstOption].units;
+        if (nextReach > target) {
+            nextReach = target;
+        }
+        int low = target - left[c] > 0 ? target - left[c] : 0;
+        int nextLow = target - left[c + 1] > 0 ? target - left[c + 1] : 0;
+        if (nextLow <= nextReach) {
+            fill(next + nextLow, next + nextReach + 1, INT_MAX);
+        }
+        for (int s = low; s <= reach; s++) {
+            if (best[s] == INT_MAX) {
+                continue;
+            }
+            for (int o = 0; o < choice->options; o++) {
+                const LiquidationOption* option = &options[choice->firstOption + o];
+                int t = s + option->units;
+                if (t < nextLow) {
+                    break; // out of reach, as are the poorer options after it
+                }
+                if (t > target) {
+                    t = target;
+                }
+                if (best[s] + option->loss < next[t]) {
+                    next[t] = best[s] + option->loss;
+                    chosen[c][t] = static_cast<unsigned short>(o);
+                    if (t == target) {
+                        fromTarget[c] = s;
+                    }
+                }
+            }
+        }
+        swap(best, next);
+        reach = nextReach;
+    }
+    bool reached = reach == target && best[target] != INT_MAX;
+    
+    // Walk back from the target. If rounding left it out of reach, the
+    // plan is to raise everything, which is enough.
+    int picked[MAX_LIQUIDATION_CHOICES];
+    int s = target;
+    for (int c = numChoices - 1; c >= 0; c--) {
+        if (!reached) {
+            picked[c] = 0;
+        } else {
+            picked[c] = chosen[c][s];
+            s = (s == target) ? fromTarget[c] : s - options[choices[c].firstOption + picked[c]].units;
+        }
+    }
+    
+    for (int c = 0; c < numChoices; c++) {
+        const LiquidationOption* option = &options[choices[c].firstOption + picked[c]];
+        SquareMask group = choices[c].group & owned;
+        
+        // Sell down to the option's state, always from a square with the
+        // most left to sell, which keeps every sale even
+        int houses[MAX_BOARD_SIZE];
+        for (SquareMask rest = group; rest != 0; rest &= rest - 1) {
+            int square = __builtin_ctzll(rest);
+            houses[square] = game->squares[square].houses;
+        }
+        for (;;) {
+            int next = -1;
+            for (SquareMask rest = group; rest != 0; rest &= rest - 1) {
+                int square = __builtin_ctzll(rest);
+                int target = targetHouses(game->squares[square].houses, option->level, option->lowered, square);
+                if (houses[square] > target && (next == -1 || houses[square] > houses[next])) {
+                    next = square;
+                }
+            }
+            if (next == -1) {
+                break;
+            }
+            houses[next]--;
+            plan->step[plan->steps++] = {static_cast<unsigned char>(LIQUIDATE_SELL_HOUSE),
+                                         static_cast<unsigned char>(next)};
+        }
+        for (SquareMask rest = option->mortgages; rest != 0; rest &= rest - 1) {
+            plan->step[plan->steps++] = {static_cast<unsigned char>(LIQUIDATE_MORTGAGE),
+                                         static_cast<unsigned char>(__builtin_ctzll(rest))};
+        }
+        plan->cash += option->cash;
+        plan->loss += option->loss;
+    }
+    return true;
+}
+
+// Carries out a plan for the current player through the ordinary sale
+// and mortgage functions, so it is journaled and reported like any other
+void executeLiquidation(GameState* game, const Property board[], const LiquidationPlan* plan) {
+    for (int i = 0; i < plan->steps; i++) {
+        if (plan->step[i].action == LIQUIDATE_SELL_HOUSE) {
+            sellHouse(game, board, plan->step[i].square);
+        } else {
+            mortgageProperty(game, board, plan->step[i].square);
+        }
+    }
+}
@@ -0,0 +1,57 @@
+#ifndef LIQUIDATION_H
+#define LIQUIDATION_H
+
+#include "monopoly.h"
+
+// A player in debt raises the money by selling houses and mortgaging
+// property, and the planner finds the way that loses the least. Selling
+// a house loses the half of its cost the bank doesn't pay back; a
+// mortgage loses the interest it takes to lift it. Squares with houses
+// can't be mortgaged, and houses must be sold evenly across a group.
+//
+// Each developed color group is one choice: how many houses to sell, in
+// the only order even selling allows (the group's sale ladder), and which
+// of its squares left without houses to mortgage. The other unmortgaged
+// squares are taken a few of a kind at a time (a color group's, the
+// railroads, the utilities), each few a choice of which to mortgage. A
+// knapsack over the choices, indexed by money raised, finds the cheapest
+// plan that covers the debt. Everything is planned in fixed buffers.
+
+const int LIQUIDATE_SELL_HOUSE = 0;
+const int LIQUIDATE_MORTGAGE = 1;
+const int MAX_LIQUIDATION_STEPS = MAX_BOARD_SIZE * (HOTEL + 1);
+
+// Knapsack size limit; larger debts are counted in coarser steps
+const int MAX_LIQUIDATION_STATES = 1024;
+
+// Groups with more squares than this choose between mortgaging none or
+// all of their bare squares rather than trying every subset; undeveloped
+// squares are taken this many at a time
+const int MAX_LIQUIDATION_SUBSET_SQUARES = 4;
+
+// A choice per color group, railroads, utilities and any other squares,
+// and one more for each further few undeveloped squares of a kind
+const int MAX_LIQUIDATION_CHOICES = NUM_COLORS + 3 + MAX_BOARD_SIZE / MAX_LIQUIDATION_SUBSET_SQUARES;
+
+// Options kept over all choices. The standard board needs a few hundred
+// at most; on a board that needs more, a choice keeps its richest options
+// that fit, which can only make a plan lose more.
+const int MAX_LIQUIDATION_OPTIONS = 1024;
+
+struct LiquidationStep {
+    unsigned char action; // LIQUIDATE_*
+    unsigned char square;
+};
+
+struct LiquidationPlan {
+    int cash; // money the steps raise
+    int loss; // value they give up
+    int steps;
+    LiquidationStep step[MAX_LIQUIDATION_STEPS];
+};
+
+// Function declarations
+bool planLiquidation(const GameState*, const Property[], int, LiquidationPlan*);
+void executeLiquidation(GameState*, const Property[], const LiquidationPlan*);
+
+#endif
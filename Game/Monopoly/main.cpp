@@ -0,0 +1,287 @@
+#include "monopoly.h"
+#include "simulation.h"
+#include "tournament.h"
+#include "journal.h"
+#include "markov.h"
+#include "events.h"
+#include "server.h"
+#include "mcts.h"
+#include "replay.h"
+#include "boardfile.h"
+#include "sweep.h"
+#include "stats.h"
+#include "whatif.h"
+
+// Replay file for the nth console game of a session (from 0): the name
+// given to --record, then name.2, name.3 and so on
+static string replayFileName(const string& name, int game) {
+    return game == 0 ? name : name + "." + to_string(game + 1);
+}
+
+// Main function
+int main(int argc, char* argv[]) {
+    // Any mode on a custom board: monopoly --board <file> [mode and options]
+    static Board customBoard;
+    if (argc > 2 && strcmp(argv[1], "--board") == 0) {
+        if (!loadBoard(argv[2], &customBoard)) {
+            return 1;
+        }
+        activeBoard = &customBoard;
+        argv[2] = argv[0];
+        argv += 2;
+        argc -= 2;
+    }
+    
+    // Headless mode: monopoly --simulate <games> [silent|summary|verbose]
+    if (argc > 2 && strcmp(argv[1], "--simulate") == 0) {
+        int outputLevel = (argc > 3) ? parseOutputLevel(argv[3]) : OUTPUT_SILENT;
+        if (outputLevel == -1) {
+            cout << "Output level must be silent, summary or verbose.\n";
+            return 1;
+        }
+        runSimulation(atoi(argv[2]), outputLevel);
+        return 0;
+    }
+    
+    // Tournament mode: monopoly --tournament <games> [threads] [seed]
+    if (argc > 2 && strcmp(argv[1], "--tournament") == 0) {
+        int numThreads = (argc > 3) ? atoi(argv[3]) : 0;
+        unsigned long long seed = (argc > 4) ? strtoull(argv[4], 0, 10) : time(0);
+        TournamentResult result = runTournament(atoll(argv[2]), numThreads, seed, &BASIC_BOT, activeBoard, 0);
+        displayTournamentResult(&result);
+        return 0;
+    }
+    
+    // Tournament with statistics: monopoly --stats <games> [threads] [seed]
+    if (argc > 2 && strcmp(argv[1], "--stats") == 0) {
+        int numThreads = (argc > 3) ? atoi(argv[3]) : 0;
+        unsigned long long seed = (argc > 4) ? strtoull(argv[4], 0, 10) : time(0);
+        static Stats stats;
+        clearStats(&stats);
+        TournamentResult result = runTournament(atoll(argv[2]), numThreads, seed, &BASIC_BOT, activeBoard, &stats);
+        displayTournamentResult(&result);
+        displayStats(&stats, activeBoard);
+        return 0;
+    }
+    
+    // Rule sweep: monopoly --sweep <games per point> <threads> <seed> <results file> [name=value,...]...
+    // where name is money, salary, fine, rent or tax (see sweep.h)
+    if (argc > 5 && strcmp(argv[1], "--sweep") == 0) {
+        SweepGrid grid;
+        initializeSweepGrid(&grid, activeBoard);
+        for (int i = 6; i < argc; i++) {
+            if (!parseSweepParameter(&grid, argv[i])) {
+                return 1;
+            }
+        }
+        return runSweep(&grid, atoll(argv[2]), atoi(argv[3]), strtoull(argv[4], 0, 10), argv[5]);
+    }
+    
+    // What-if from a save: monopoly --whatif <save file> <player> <square> [turns] [branches] [threads] [seed]
+    if (argc > 4 && strcmp(argv[1], "--whatif") == 0) {
+        int turns = (argc > 5) ? atoi(argv[5]) : WHATIF_DEFAULT_TURNS;
+        long long branches = (argc > 6) ? atoll(argv[6]) : 1000;
+        int numThreads = (argc > 7) ? atoi(argv[7]) : 0;
+        unsigned long long seed = (argc > 8) ? strtoull(argv[8], 0, 10) : time(0);
+        return runWhatIf(argv[2], atoi(argv[3]) - 1, atoi(argv[4]), turns, branches, numThreads, seed);
+    }
+    
+    // Search bot against the basic bot: monopoly --mcts <games> [ms per decision] [threads] [seed]
+    if (argc > 2 && strcmp(argv[1], "--mcts") == 0) {
+        int budgetMs = (argc > 3) ? atoi(argv[3]) : MCTS_DEFAULT_BUDGET_MS;
+        int numThreads = (argc > 4) ? atoi(argv[4]) : MCTS_DEFAULT_THREADS;
+        unsigned long long seed = (argc > 5) ? strtoull(argv[5], 0, 10) : time(0);
+        runMctsMatch(atoi(argv[2]), budgetMs, numThreads, seed);
+        return 0;
+    }
+    
+    // Server mode: monopoly --server <socket path> [threads] [max games]
+    if (argc > 2 && strcmp(argv[1], "--server") == 0) {
+        int numThreads = (argc > 3) ? atoi(argv[3]) : DEFAULT_SERVER_THREADS;
+        int numGames = (argc > 4) ? atoi(argv[4]) : DEFAULT_SERVER_GAMES;
+        return runServer(argv[2], numThreads, numGames);
+    }
+    
+    // Replay recorded games: monopoly --replay [verify] <file>...
+    if (argc > 2 && strcmp(argv[1], "--replay") == 0) {
+        bool verify = strcmp(argv[2], "verify") == 0;
+        int first = verify ? 3 : 2;
+        return runReplays(argv + first, argc - first, verify);
+    }
+    
+    // Landing probabilities: monopoly --markov [roll|pay] [file.csv]
+    if (argc > 1 && strcmp(argv[1], "--markov") == 0) {
+        int jailStrategy = (argc > 2 && strcmp(argv[2], "pay") == 0) ? JAIL_STRATEGY_PAY : JAIL_STRATEGY_ROLL;
+        LandingProbabilities result = solveLandingProbabilities(activeBoard, jailStrategy);
+        displayLandingProbabilities(&result, activeBoard);
+        if (argc > 3) {
+            exportLandingProbabilities(&result, activeBoard, argv[3]);
+        }
+        return 0;
+    }
+    
+    // Console game: monopoly [--seed <n>] [--record <replay file>]
+    // --seed fixes the dice for reproducing a game; --record writes a
+    // replay of each game played (see replay.h)
+    unsigned long long seed = static_cast<unsigned long long>(time(0));
+    string recordFile;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--seed") == 0) {
+            seed = strtoull(argv[i + 1], 0, 10);
+        } else if (strcmp(argv[i], "--record") == 0) {
+            recordFile = argv[i + 1];
+        }
+    }
+    int gamesRecorded = 0;
+    
+    GameState gameState;
+    PlayerNames names;
+    Journal journal;
+    Replay replay;
+    initializeBoard(&gameState, activeBoard);
+    gameState.names = &names;
+    gameState.journal = 0;
+    gameState.undo = 0;
+    gameState.replay = 0;
+    gameState.stats = 0;
+    gameState.outputLevel = OUTPUT_VERBOSE;
+    seedDice(&gameState.dice, seed);
+    const Property* board = gameState.board->squares;
+    char choice;
+    bool exitProgram = false;
+    
+    // A journal left on disk means the last game didn't shut down cleanly
+    bool resumeJournal = false;
+    if (recoverJournal(&gameState, &names)) {
+        cout << "Resume the interrupted game? (y/n): ";
+        cin >> choice;
+        resumeJournal = (choice == 'y' || choice == 'Y');
+        if (!resumeJournal) {
+            remove(JOURNAL_FILE);
+        }
+    }
+    
+    while (!exitProgram) {
+        if (resumeJournal) {
+            choice = '1';
+        } else {
+            cout << "=== Welcome to Monopoly! ===\n\n";
+            cout << "1. Load Saved Game\n";
+            cout << "2. Start New Game\n";
+            cout << "3. Exit\n";
+            cout << "Choose an option (1-3): ";
+            cin >> choice;
+        }
+        
+        switch (choice) {
+            case '1': {
+                if (resumeJournal) {
+                    resumeJournal = false;
+                } else if (!loadGame(&gameState, &names)) {
+                    cout << "Would you like to start a new game instead? (y/n): ";
+                    cin >> choice;
+                    if (choice != 'y' && choice != 'Y') {
+                        continue;  // Go back to main menu
+                    }
+                    initializeBoard(&gameState, activeBoard);
+                    initializeCards(&gameState);
+                    initializePlayers(&gameState, &names);
+                }
+                rebuildOwnershipIndex(&gameState, board);
+                openJournal(&journal, &gameState);
+                if (!recordFile.empty()) {
+                    openReplay(&replay, &gameState, replayFileName(recordFile, gamesRecorded++));
+                }
+                
+                gameState.gameOver = false;  // Reset game over flag
+                // Game loop
+                while (!gameState.gameOver) {
+                    displayGameState(&gameState, board);
+                    processPlayerTurn(&gameState, board);
+                    
+                    if (checkWinCondition(&gameState)) {
+                        gameState.gameOver = true;
+                        continue;
+                    }
+                    
+                    cout << "\nContinue playing? (y/n): ";
+                    cin >> choice;
+                    if (choice != 'y' && choice != 'Y') {
+                        cout << "Would you like to save the game? (y/n): ";
+                        cin >> choice;
+                        if (choice == 'y' || choice == 'Y') {
+                            saveGame(&gameState, board);
+                        }
+                        break;
+                    }
+                }
+                closeJournal(&journal, &gameState);
+                closeReplay(&replay, &gameState);
+                break;
+            }
+            
+            case '2': {
+                // Initialize new game
+                initializeBoard(&gameState, activeBoard);
+                initializeCards(&gameState);
+                initializePlayers(&gameState, &names);
+                rebuildOwnershipIndex(&gameState, board);
+                openJournal(&journal, &gameState);
+                if (!recordFile.empty()) {
+                    openReplay(&replay, &gameState, replayFileName(recordFile, gamesRecorded++));
+                }
+                
+                gameState.gameOver = false;  // Reset game over flag
+                // Game loop
+                while (!gameState.gameOver) {
+                    displayGameState(&gameState, board);
+                    processPlayerTurn(&gameState, board);
+                    
+                    if (checkWinCondition(&gameState)) {
+                        gameState.gameOver = true;
+                        continue;
+                    }
+                    
+                    cout << "\nContinue playing? (y/n): ";
+                    cin >> choice;
+                    if (choice != 'y' && choice != 'Y') {
+                        cout << "Would you like to save the game? (y/n): ";
+                        cin >> choice;
+                        if (choice == 'y' || choice == 'Y') {
+                            saveGame(&gameState, board);
+                        }
+                        break;
+                    }
+                }
+                closeJournal(&journal, &gameState);
+                closeReplay(&replay, &gameState);
+                break;
+            }
+            
+            case '3': {
+                exitProgram = true;
+                cout << "\nThanks for playing Monopoly!\n";
+                break;
+            }
+            
+            default: {
+                cout << "Invalid choice. Please try again.\n\n";
+                cin.clear();
+                cin.ignore(10000, '\n');
+                break;
+            }
+        }
+        
+        if (!exitProgram && !gameState.gameOver) {
+            cout << "\nWould you like to return to the main menu? (y/n): ";
+            cin >> choice;
+            if (choice != 'y' && choice != 'Y') {
+                exitProgram = true;
+                cout << "\nThanks for playing Monopoly!\n";
+            }
+            cout << "\n";
+        }
+    }
+    
+    return 0;
+}
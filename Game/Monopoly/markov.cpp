@@ -0,0 +1,162 @@
+#include "markov.h"
+
+// Probability of each (die1, die2) outcome
+const double DICE_OUTCOME = 1.0 / 36.0;
+
+static int jailState(const Board* board, int turnsServed) {
+    return board->size + turnsServed;
+}
+
+// Where a player standing on a square after movePlayer ends up once
+// handleSpecialSpace has run, spread over the outcomes. Card draws are
+// taken as uniform over the deck slots, which is their long-run rate, and
+// a card that moves the player lands them like any other move.
+static void addLanding(const Board* board, double row[], int square, double probability) {
+    const Property* property = &board->squares[square];
+    
+    if (square == board->goToJailSquare) {
+        row[jailState(board, 0)] += probability;
+        return;
+    }
+    
+    if (property->type == 4 || property->type == 5) { // CHANCE or COMMUNITY_CHEST
+        int deck = property->type == 4 ? CHANCE_DECK : COMMUNITY_DECK;
+        double perCard = probability / DECK_SIZE;
+        for (int slot = 0; slot < DECK_SIZE; slot++) {
+            const Card& card = board->cards[deck][slot];
+            int destination = cardDestination(board, card, square);
+            if (card.actionType == CARD_GO_TO_JAIL) {
+                row[jailState(board, 0)] += perCard;
+            } else if (destination != square) {
+                addLanding(board, row, destination, perCard);
+            } else {
+                row[square] += perCard;
+            }
+        }
+        return;
+    }
+    
+    row[square] += probability;
+}
+
+// Rows are the state before a roll, columns the state after it. Follows the
+// engine's turn (see turn.cpp): an ordinary roll for free players,
+// handleJailTurn for jailed ones (a jail exit moves but doesn't resolve
+// special squares).
+void buildTransitionMatrix(const Board* board, int jailStrategy, double matrix[][MARKOV_STATES]) {
+    for (int i = 0; i < MARKOV_STATES; i++) {
+        for (int j = 0; j < MARKOV_STATES; j++) {
+            matrix[i][j] = 0.0;
+        }
+    }
+    
+    for (int square = 0; square < board->size; square++) {
+        for (int die1 = 1; die1 <= 6; die1++) {
+            for (int die2 = 1; die2 <= 6; die2++) {
+                addLanding(board, matrix[square], (square + die1 + die2) % board->size, DICE_OUTCOME);
+            }
+        }
+    }
+    
+    for (int turns = 0; turns < JAIL_STATES; turns++) {
+        double* row = matrix[jailState(board, turns)];
+        for (int die1 = 1; die1 <= 6; die1++) {
+            for (int die2 = 1; die2 <= 6; die2++) {
+                int exitSquare = (board->jailSquare + die1 + die2) % board->size;
+                if (jailStrategy == JAIL_STRATEGY_PAY || die1 == die2 || turns == JAIL_STATES - 1) {
+                    row[exitSquare] += DICE_OUTCOME;
+                } else {
+                    row[jailState(board, turns + 1)] += DICE_OUTCOME;
+                }
+            }
+        }
+    }
+}
+
+// Stationary distribution by power iteration. The update is written as
+// next += current[i] * row i so the inner loop runs along contiguous
+// memory and the compiler can vectorize it. The matrix (about 36KB) is on
+// the stack, so solves for different boards can run at the same time.
+LandingProbabilities solveLandingProbabilities(const Board* board, int jailStrategy) {
+    double matrix[MARKOV_STATES][MARKOV_STATES];
+    buildTransitionMatrix(board, jailStrategy, matrix);
+    
+    double current[MARKOV_STATES];
+    double next[MARKOV_STATES];
+    for (int i = 0; i < MARKOV_STATES; i++) {
+        current[i] = (i == 0) ? 1.0 : 0.0; // everyone starts on GO
+    }
+    
+    LandingProbabilities result;
+    result.jailStrategy = jailStrategy;
+    result.iterations = 0;
+    
+    while (result.iterations < MARKOV_MAX_ITERATIONS) {
+        for (int j = 0; j < MARKOV_STATES; j++) {
+            next[j] = 0.0;
+        }
+        for (int i = 0; i < MARKOV_STATES; i++) {
+            double weight = current[i];
+            const double* row = matrix[i];
+            for (int j = 0; j < MARKOV_STATES; j++) {
+                next[j] += weight * row[j];
+            }
+        }
+        result.iterations++;
+        
+        // Averaging with the previous step keeps the same fixed point but
+        // damps the slow ripple round the board: about half the iterations
+        double change = 0.0;
+        for (int j = 0; j < MARKOV_STATES; j++) {
+            next[j] = 0.5 * (next[j] + current[j]);
+            change += next[j] > current[j] ? next[j] - current[j] : current[j] - next[j];
+            current[j] = next[j];
+        }
+        if (change < MARKOV_TOLERANCE) {
+            break;
+        }
+    }
+    
+    for (int i = 0; i < board->size; i++) {
+        result.square[i] = current[i];
+    }
+    result.inJail = 0.0;
+    for (int i = 0; i < JAIL_STATES; i++) {
+        result.inJail += current[jailState(board, i)];
+    }
+    return result;
+}
+
+void displayLandingProbabilities(const LandingProbabilities* result, const Board* board) {
+    cout << "\n=== Landing Probabilities ("
+         << (result->jailStrategy == JAIL_STRATEGY_PAY ? "pay to leave jail" : "roll to leave jail")
+         << ", " << result->iterations << " iterations) ===\n";
+    cout << fixed << setprecision(4);
+    for (int i = 0; i < board->size; i++) {
+        cout << setw(2) << i << ". " << left << setw(25) << board->squares[i].name << right
+             << setw(8) << result->square[i] * 100.0 << "%\n";
+    }
+    cout << "    " << left << setw(25) << "In Jail" << right
+         << setw(8) << result->inJail * 100.0 << "%\n";
+    cout.unsetf(ios::fixed);
+    cout << setprecision(6);
+}
+
+// CSV: square,name,probability. The jail row uses square -1.
+bool exportLandingProbabilities(const LandingProbabilities* result, const Board* board, const char* filename) {
+    ofstream outFile(filename);
+    if (!outFile) {
+        cout << "Error opening " << filename << "!\n";
+        return false;
+    }
+    
+    outFile << "square,name,probability\n" << setprecision(12);
+    for (int i = 0; i < board->size; i++) {
+        outFile << i << ",\"" << board->squares[i].name << "\"," << result->square[i] << "\n";
+    }
+    outFile << -1 << ",\"In Jail\"," << result->inJail << "\n";
+    
+    outFile.close();
+    cout << "Landing probabilities written to " << filename << "\n";
+    return true;
+}
@@ -0,0 +1,32 @@
+#ifndef MARKOV_H
+#define MARKOV_H
+
+#include "monopoly.h"
+
+// One state per square, plus one per turn already spent in jail. The
+// square states are "after a roll, standing here"; the jail square in
+// that range means just visiting. Smaller boards leave states unused.
+const int JAIL_STATES = 3;
+const int MARKOV_STATES = MAX_BOARD_SIZE + JAIL_STATES;
+
+// What a jailed player does, matching the controller's jail choices
+const int JAIL_STRATEGY_ROLL = 0; // roll for doubles, pay on the third turn
+const int JAIL_STRATEGY_PAY = 1;  // pay the fine and roll straight away
+
+const int MARKOV_MAX_ITERATIONS = 10000;
+const double MARKOV_TOLERANCE = 1e-13;
+
+struct LandingProbabilities {
+    double square[MAX_BOARD_SIZE]; // probability of ending a roll on each square
+    double inJail;                 // probability of being held in jail
+    int jailStrategy;
+    int iterations;
+};
+
+// Function declarations
+void buildTransitionMatrix(const Board*, int, double[][MARKOV_STATES]);
+LandingProbabilities solveLandingProbabilities(const Board*, int);
+void displayLandingProbabilities(const LandingProbabilities*, const Board*);
+bool exportLandingProbabilities(const LandingProbabilities*, const Board*, const char*);
+
+#endif
@@ -0,0 +1,640 @@
+#include "mcts.h"
+#include "turn.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+#include <chrono>
+#include <cmath>
+
+MctsBot DEFAULT_MCTS_BOT = {
+    {MCTS_DEFAULT_BUDGET_MS, 0, MCTS_DEFAULT_THREADS, MCTS_ROLLOUT_TURNS, 0},
+    {0, 0, 0, 0.0, 0.0},
+    {false, 0, 0, 0, 0},
+    0
+};
+
+// An answer tried at a node. Since every iteration rolls different dice,
+// one node can be reached facing different decisions, so answers are
+// kept per decision key (the decision, and the square for purchases).
+struct MctsEdge {
+    int key;
+    int answer;
+    int child; // node the answer leads to, -1 if the tree was full
+    int visits;
+    double totalScore;
+};
+
+struct MctsNode {
+    vector<MctsEdge> edges;
+};
+
+struct MctsStep {
+    int node;
+    int edge;
+};
+
+// One search thread's tree and dice. Kept from one decision to the next,
+// so the nodes' storage is reused.
+struct MctsSearch {
+    vector<MctsNode> tree;
+    int numNodes; // nodes in use; tree can hold more from earlier searches
+    vector<MctsStep> path;
+    int iterations;
+    DiceRng rng;
+};
+
+// The decision being searched, shared read-only by the search threads
+struct MctsJob {
+    const GameState* root;
+    const Property* board;
+    int decision;
+    int key;
+    const int* answers;
+    int numAnswers;
+    int maxIterations; // per thread, 0 for no limit
+    int rolloutTurns;
+    chrono::steady_clock::time_point deadline;
+};
+
+// Search threads kept for the bot's lifetime. searches[0] is run by the
+// thread asking for the decision and searches[i] by threads[i - 1], which
+// waits for jobNumber to change, searches and counts running down.
+struct MctsPool {
+    mutex lock;
+    condition_variable jobReady;
+    condition_variable jobDone;
+    long long jobNumber;
+    int running; // pool threads still searching the current job
+    bool stopping;
+    MctsJob job;
+    vector<MctsSearch> searches;
+    vector<thread> threads;
+};
+
+// The searching player's controller in an iteration's copy of the game
+struct MctsWalker {
+    MctsSearch* search;
+    int node; // -1 once the iteration has left the tree
+    MctsBuildPlan plan;
+};
+
+void initializeMctsBot(MctsBot* bot, int budgetMs, int threads, unsigned long long seed) {
+    bot->config.budgetMs = budgetMs;
+    bot->config.maxIterations = 0;
+    bot->config.threads = (threads > 0) ? threads : 1;
+    bot->config.rolloutTurns = MCTS_ROLLOUT_TURNS;
+    bot->config.seed = seed;
+    memset(&bot->stats, 0, sizeof(MctsStats));
+    bot->plan.active = false;
+    bot->pool = 0;
+}
+
+static int decisionKey(int decision, int square) {
+    return decision * MAX_BOARD_SIZE + square;
+}
+
+// Jail answers the current player has
+static int jailAnswers(const GameState* game, int answers[]) {
+    const Player* player = &game->players[game->currentPlayer];
+    int numAnswers = 0;
+    
+    answers[numAnswers++] = 3;
+    if (player->money >= game->board->jailFine) {
+        answers[numAnswers++] = 1;
+    }
+    if (player->getOutOfJailCards > 0) {
+        answers[numAnswers++] = 2;
+    }
+    return numAnswers;
+}
+
+// Build plans open to the current player: -1 for none, else houses *
+// NUM_COLORS + color. Per group that is one house up to one a square, then
+// whole rounds, then the most the player can afford.
+static int buildAnswers(const GameState* game, const Property board[], int answers[]) {
+    const Player* player = &game->players[game->currentPlayer];
+    int numAnswers = 0;
+    
+    answers[numAnswers++] = -1;
+    for (int color = 0; color < NUM_COLORS; color++) {
+        SquareMask group = game->board->colorMasks[color];
+        int room = 0;
+        int houseCost = -1;
+        for (SquareMask rest = group; rest != 0; rest &= rest - 1) {
+            int square = __builtin_ctzll(rest);
+            room += HOTEL - game->squares[square].houses;
+            if (houseCost == -1 && canBuildHouse(game, board, square)) {
+                houseCost = board[square].houseCost;
+            }
+        }
+        if (houseCost == -1) {
+            continue;
+        }
+        
+        int most = (houseCost > 0) ? min(room, player->money / houseCost) : room;
+        int size = countSquares(group);
+        int houses = 1;
+        while (houses <= most) {
+            answers[numAnswers++] = houses * NUM_COLORS + color;
+            if (houses < size) {
+                houses++;
+            } else if (houses + size <= most || houses == most) {
+                houses += size;
+            } else {
+                houses = most;
+            }
+        }
+    }
+    return numAnswers;
+}
+
+static void startBuildPlan(const GameState* game, int answer, MctsBuildPlan* plan) {
+    plan->active = true;
+    plan->player = game->currentPlayer;
+    plan->color = (answer == -1) ? 0 : answer % NUM_COLORS;
+    plan->housesLeft = (answer == -1) ? 0 : answer / NUM_COLORS;
+    plan->money = game->players[game->currentPlayer].money;
+}
+
+// Whether the current player is part way through the plan
+static bool continuingBuildPlan(const GameState* game, const MctsBuildPlan* plan) {
+    return plan->active && plan->player == game->currentPlayer &&
+           plan->money == game->players[game->currentPlayer].money;
+}
+
+// The plan's next house, or -1 (ending the plan) once it is done or can't
+// go on
+static int nextPlannedBuild(const GameState* game, const Property board[], MctsBuildPlan* plan) {
+    plan->active = false;
+    if (plan->housesLeft == 0) {
+        return -1;
+    }
+    for (SquareMask rest = game->board->colorMasks[plan->color]; rest != 0; rest &= rest - 1) {
+        int square = __builtin_ctzll(rest);
+        if (canBuildHouse(game, board, square)) {
+            plan->active = true;
+            plan->housesLeft--;
+            plan->money = game->players[game->currentPlayer].money - board[square].houseCost;
+            return square;
+        }
+    }
+    return -1;
+}
+
+static int newNode(MctsSearch* search) {
+    if (search->numNodes == static_cast<int>(search->tree.size())) {
+        search->tree.push_back(MctsNode());
+    } else {
+        search->tree[search->numNodes].edges.clear();
+    }
+    return search->numNodes++;
+}
+
+// Picks the walker's answer at its node: the first answer not tried there
+// yet, which grows the tree by a node and ends the walk, or else the best
+// by UCT, which moves the walker down to the answer's node
+static int walkTree(MctsWalker* walker, int key, const int answers[], int numAnswers) {
+    MctsSearch* search = walker->search;
+    int found[MAX_MCTS_ANSWERS];
+    int parentVisits = 0;
+    
+    for (int i = 0; i < numAnswers; i++) {
+        const vector<MctsEdge>& edges = search->tree[walker->node].edges;
+        found[i] = -1;
+        for (int e = 0; e < static_cast<int>(edges.size()); e++) {
+            if (edges[e].key == key && edges[e].answer == answers[i]) {
+                found[i] = e;
+                break;
+            }
+        }
+        if (found[i] == -1) {
+            MctsEdge edge = {key, answers[i], -1, 0, 0.0};
+            if (search->numNodes < MCTS_MAX_NODES) {
+                edge.child = newNode(search);
+            }
+            search->tree[walker->node].edges.push_back(edge);
+            MctsStep step = {walker->node, static_cast<int>(search->tree[walker->node].edges.size()) - 1};
+            search->path.push_back(step);
+            walker->node = -1;
+            return answers[i];
+        }
+        parentVisits += edges[found[i]].visits;
+    }
+    
+    const vector<MctsEdge>& edges = search->tree[walker->node].edges;
+    double logVisits = log(static_cast<double>(parentVisits));
+    int pick = 0;
+    double bestBound = -1.0;
+    for (int i = 0; i < numAnswers; i++) {
+        const MctsEdge* edge = &edges[found[i]];
+        double bound = edge->totalScore / edge->visits + MCTS_EXPLORATION * sqrt(logVisits / edge->visits);
+        if (bound > bestBound) {
+            bestBound = bound;
+            pick = i;
+        }
+    }
+    MctsStep step = {walker->node, found[pick]};
+    search->path.push_back(step);
+    walker->node = edges[found[pick]].child;
+    return answers[pick];
+}
+
+// Walker Controller Functions: the tree's answers while the iteration is
+// in it, the basic bot's after
+static bool walkWantsToBuy(const GameState* game, const Property board[], int propertyIndex, void* context) {
+    MctsWalker* walker = static_cast<MctsWalker*>(context);
+    if (walker->node == -1) {
+        return BASIC_BOT.wantsToBuy(game, board, propertyIndex, BASIC_BOT.context);
+    }
+    int answers[2] = {1, 0};
+    return walkTree(walker, decisionKey(DECISION_BUY, propertyIndex), answers, 2) == 1;
+}
+
+static int walkChooseJailOption(const GameState* game, const Property board[], void* context) {
+    MctsWalker* walker = static_cast<MctsWalker*>(context);
+    int answers[3];
+    int numAnswers = jailAnswers(game, answers);
+    if (walker->node == -1 || numAnswers == 1) {
+        return BASIC_BOT.chooseJailOption(game, board, BASIC_BOT.context);
+    }
+    return walkTree(walker, decisionKey(DECISION_JAIL, 0), answers, numAnswers);
+}
+
+static int walkChooseBuild(const GameState* game, const Property board[], void* context) {
+    MctsWalker* walker = static_cast<MctsWalker*>(context);
+    if (!continuingBuildPlan(game, &walker->plan)) {
+        if (walker->node == -1) {
+            return BASIC_BOT.chooseBuild(game, board, BASIC_BOT.context);
+        }
+        int answers[MAX_MCTS_ANSWERS];
+        int numAnswers = buildAnswers(game, board, answers);
+        if (numAnswers == 1) {
+            return -1;
+        }
+        startBuildPlan(game, walkTree(walker, decisionKey(DECISION_ROLL, 0), answers, numAnswers), &walker->plan);
+    }
+    return nextPlannedBuild(game, board, &walker->plan);
+}
+
+static int walkChooseMortgage(const GameState* game, const Property board[], void* context) {
+    return BASIC_BOT.chooseMortgage(game, board, BASIC_BOT.context);
+}
+
+static int walkChooseUnmortgage(const GameState* game, const Property board[], void* context) {
+    return BASIC_BOT.chooseUnmortgage(game, board, BASIC_BOT.context);
+}
+
+static bool walkProposeTrade(const GameState* game, const Property board[], TradeOffer* offer, void* context) {
+    return BASIC_BOT.proposeTrade(game, board, offer, BASIC_BOT.context);
+}
+
+static bool walkAcceptTrade(const GameState* game, const Property board[], const TradeOffer* offer, void* context) {
+    return BASIC_BOT.acceptTrade(game, board, offer, BASIC_BOT.context);
+}
+
+// The player's share of the net worth still in the game: 1 for a win,
+// 0 for bankruptcy
+static double rolloutScore(const GameState* game, const Property board[], int playerNum) {
+    if (game->players[playerNum].bankrupt) {
+        return 0.0;
+    }
+    double total = 0.0;
+    for (int i = 0; i < game->numPlayers; i++) {
+        if (!game->players[i].bankrupt) {
+            total += max(netWorth(game, board, i), 0);
+        }
+    }
+    return (total > 0.0) ? max(netWorth(game, board, playerNum), 0) / total : 0.0;
+}
+
+// Applies an answer to a copy of the game and plays it out. For
+// DECISION_ROLL the answer is a build plan, carried out in full before
+// rolling.
+static double playOut(GameState* game, const Property board[], int decision, int answer, int turns) {
+    int playerNum = game->currentPlayer;
+    int next = decision;
+    
+    if (decision == DECISION_ROLL) {
+        MctsBuildPlan plan;
+        startBuildPlan(game, answer, &plan);
+        int square;
+        while ((square = nextPlannedBuild(game, board, &plan)) != -1) {
+            buildHouse(game, board, square);
+        }
+    } else {
+        next = resumeTurn(game, board, answer);
+    }
+    // Finish the turn without another round of pre-roll actions
+    while (next != DECISION_NONE) {
+        next = resumeTurn(game, board, controllerAnswer(game, board, next));
+    }
+    
+    if (checkWinCondition(game)) {
+        game->gameOver = true;
+    }
+    playGame(game, board, turns);
+    return rolloutScore(game, board, playerNum);
+}
+
+static void runSearch(const MctsJob* job, MctsSearch* search) {
+    search->numNodes = 0;
+    search->iterations = 0;
+    newNode(search); // the root
+    
+    MctsWalker walker;
+    walker.search = search;
+    PlayerController walkerController = {
+        walkWantsToBuy,
+        walkChooseJailOption,
+        walkChooseBuild,
+        walkChooseMortgage,
+        walkChooseUnmortgage,
+        walkProposeTrade,
+        walkAcceptTrade,
+        &walker
+    };
+    int playerNum = job->root->currentPlayer;
+    GameState game;
+    
+    while (job->maxIterations == 0 || search->iterations < job->maxIterations) {
+        if (search->iterations % MCTS_CLOCK_INTERVAL == 0 && search->iterations >= job->numAnswers &&
+            chrono::steady_clock::now() >= job->deadline) {
+            break;
+        }
+        
+        // Basic bots in every other seat, on the next dice of this
+        // search's own stream
+        game = *job->root;
+        game.dice.rng = search->rng;
+        game.dice.next = DICE_BUFFER_SIZE;
+        game.outputLevel = OUTPUT_SILENT;
+        game.journal = 0;
+        game.undo = 0;
+        game.replay = 0;
+        game.stats = 0;
+        for (int i = 0; i < game.numPlayers; i++) {
+            game.controllers[i] = &BASIC_BOT;
+        }
+        game.controllers[playerNum] = &walkerController;
+        walker.node = 0;
+        walker.plan.active = false;
+        search->path.clear();
+        
+        int answer = walkTree(&walker, job->key, job->answers, job->numAnswers);
+        double score = playOut(&game, job->board, job->decision, answer, job->rolloutTurns);
+        search->rng = game.dice.rng;
+        
+        for (size_t i = 0; i < search->path.size(); i++) {
+            MctsEdge* edge = &search->tree[search->path[i].node].edges[search->path[i].edge];
+            edge->visits++;
+            edge->totalScore += score;
+        }
+        search->iterations++;
+    }
+}
+
+static void poolThread(MctsPool* pool, int id) {
+    long long searched = 0;
+    for (;;) {
+        {
+            unique_lock<mutex> guard(pool->lock);
+            pool->jobReady.wait(guard, [pool, searched] { return pool->stopping || pool->jobNumber != searched; });
+            if (pool->stopping) {
+                return;
+            }
+            searched = pool->jobNumber;
+        }
+        
+        runSearch(&pool->job, &pool->searches[id]);
+        {
+            lock_guard<mutex> guard(pool->lock);
+            pool->running--;
+        }
+        pool->jobDone.notify_one();
+    }
+}
+
+static MctsPool* startPool(int threads) {
+    MctsPool* pool = new MctsPool;
+    pool->jobNumber = 0;
+    pool->running = 0;
+    pool->stopping = false;
+    pool->searches.resize(threads);
+    for (int i = 1; i < threads; i++) {
+        pool->threads.push_back(thread(poolThread, pool, i));
+    }
+    return pool;
+}
+
+// Stops the bot's search threads and frees its trees. The bot can still
+// be used; the next search starts them again.
+void releaseMctsBot(MctsBot* bot) {
+    MctsPool* pool = bot->pool;
+    if (pool == 0) {
+        return;
+    }
+    {
+        lock_guard<mutex> guard(pool->lock);
+        pool->stopping = true;
+    }
+    pool->jobReady.notify_all();
+    for (size_t i = 0; i < pool->threads.size(); i++) {
+        pool->threads[i].join();
+    }
+    delete pool;
+    bot->pool = 0;
+}
+
+// Picks one of the answers to a decision the current player faces. The
+// searches run on copies, so the real game isn't touched.
+int chooseMctsAnswer(const GameState* game, const Property board[], int decision, const int answers[],
+                     int numAnswers, MctsBot* bot) {
+    const MctsConfig* config = &bot->config;
+    if (numAnswers == 1) {
+        return answers[0];
+    }
+    bot->stats.decisions++;
+    
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    int threads = max(config->threads, 1);
+    if (bot->pool != 0 && static_cast<int>(bot->pool->searches.size()) != threads) {
+        releaseMctsBot(bot);
+    }
+    if (bot->pool == 0) {
+        bot->pool = startPool(threads);
+    }
+    MctsPool* pool = bot->pool;
+    
+    // Each search rolls its own split of the decision's dice
+    DiceRng decisionRng;
+    seedDiceRng(&decisionRng, config->seed ^ game->dice.rng.s[0] ^ static_cast<unsigned long long>(bot->stats.decisions));
+    for (int i = 0; i < threads; i++) {
+        splitDiceRng(&decisionRng, &pool->searches[i].rng);
+    }
+    
+    {
+        lock_guard<mutex> guard(pool->lock);
+        MctsJob* job = &pool->job;
+        job->root = game;
+        job->board = board;
+        job->decision = decision;
+        job->key = decisionKey(decision, decision == DECISION_BUY ? game->turn.square : 0);
+        job->answers = answers;
+        job->numAnswers = numAnswers;
+        job->maxIterations = (config->maxIterations > 0) ? max(config->maxIterations / threads, 1) : 0;
+        job->rolloutTurns = config->rolloutTurns;
+        job->deadline = start + chrono::milliseconds(config->budgetMs);
+        pool->running = threads - 1;
+        pool->jobNumber++;
+    }
+    pool->jobReady.notify_all();
+    runSearch(&pool->job, &pool->searches[0]);
+    {
+        unique_lock<mutex> guard(pool->lock);
+        pool->jobDone.wait(guard, [pool] { return pool->running == 0; });
+    }
+    
+    // Root visits summed over the trees; every root edge answers this decision
+    int visits[MAX_MCTS_ANSWERS] = {0};
+    double totalScore[MAX_MCTS_ANSWERS] = {0.0};
+    for (int i = 0; i < threads; i++) {
+        const MctsSearch* search = &pool->searches[i];
+        const vector<MctsEdge>& edges = search->tree[0].edges;
+        for (size_t e = 0; e < edges.size(); e++) {
+            for (int j = 0; j < numAnswers; j++) {
+                if (edges[e].answer == answers[j]) {
+                    visits[j] += edges[e].visits;
+                    totalScore[j] += edges[e].totalScore;
+                }
+            }
+        }
+        bot->stats.iterations += search->iterations;
+        bot->stats.nodes += search->numNodes;
+    }
+    
+    // Most visited answer, ties going to the better mean score
+    int best = 0;
+    for (int i = 1; i < numAnswers; i++) {
+        if (visits[i] > visits[best] || (visits[i] == visits[best] && totalScore[i] > totalScore[best])) {
+            best = i;
+        }
+    }
+    
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    bot->stats.totalSeconds += seconds;
+    bot->stats.maxSeconds = max(bot->stats.maxSeconds, seconds);
+    return answers[best];
+}
+
+// MCTS Bot Functions
+static bool mctsWantsToBuy(const GameState* game, const Property board[], int propertyIndex, void* context) {
+    int answers[2] = {1, 0};
+    return chooseMctsAnswer(game, board, DECISION_BUY, answers, 2, static_cast<MctsBot*>(context)) == 1;
+}
+
+static int mctsChooseJailOption(const GameState* game, const Property board[], void* context) {
+    int answers[3];
+    int numAnswers = jailAnswers(game, answers);
+    return chooseMctsAnswer(game, board, DECISION_JAIL, answers, numAnswers, static_cast<MctsBot*>(context));
+}
+
+// Searches once per pre-roll build, for a whole plan, then hands the plan
+// out a house per call
+static int mctsChooseBuild(const GameState* game, const Property board[], void* context) {
+    MctsBot* bot = static_cast<MctsBot*>(context);
+    if (!continuingBuildPlan(game, &bot->plan)) {
+        int answers[MAX_MCTS_ANSWERS];
+        int numAnswers = buildAnswers(game, board, answers);
+        int answer = chooseMctsAnswer(game, board, DECISION_ROLL, answers, numAnswers, bot);
+        if (answer == -1) {
+            bot->plan.active = false;
+            return -1;
+        }
+        startBuildPlan(game, answer, &bot->plan);
+    }
+    return nextPlannedBuild(game, board, &bot->plan);
+}
+
+// Mortgages and trades are left to the basic bot's rules
+static int mctsChooseMortgage(const GameState* game, const Property board[], void* context) {
+    return BASIC_BOT.chooseMortgage(game, board, BASIC_BOT.context);
+}
+
+static int mctsChooseUnmortgage(const GameState* game, const Property board[], void* context) {
+    return BASIC_BOT.chooseUnmortgage(game, board, BASIC_BOT.context);
+}
+
+static bool mctsProposeTrade(const GameState* game, const Property board[], TradeOffer* offer, void* context) {
+    return BASIC_BOT.proposeTrade(game, board, offer, BASIC_BOT.context);
+}
+
+static bool mctsAcceptTrade(const GameState* game, const Property board[], const TradeOffer* offer,
+                            void* context) {
+    return BASIC_BOT.acceptTrade(game, board, offer, BASIC_BOT.context);
+}
+
+PlayerController MCTS_BOT = {
+    mctsWantsToBuy,
+    mctsChooseJailOption,
+    mctsChooseBuild,
+    mctsChooseMortgage,
+    mctsChooseUnmortgage,
+    mctsProposeTrade,
+    mctsAcceptTrade,
+    &DEFAULT_MCTS_BOT
+};
+
+PlayerController mctsController(MctsBot* bot) {
+    PlayerController controller = MCTS_BOT;
+    controller.context = bot;
+    return controller;
+}
+
+// Two-player games, search bot in seat 1 against the basic bot. Games
+// that hit the turn limit go to whoever has the larger net worth.
+void runMctsMatch(int numGames, int budgetMs, int threads, unsigned long long seed) {
+    MctsBot bot;
+    initializeMctsBot(&bot, budgetMs, threads, seed);
+    PlayerController controller = mctsController(&bot);
+    GameState game;
+    int wins[2] = {0, 0};
+    int leads[2] = {0, 0};
+    long long totalTurns = 0;
+    DiceStreams streams;
+    seedDiceStreams(&streams, seed);
+    DiceRng rng;
+    
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (int i = 0; i < numGames; i++) {
+        findDiceStream(&streams, i, &rng);
+        setupHeadlessGameWithDice(&game, activeBoard, 2, &BASIC_BOT, &rng);
+        game.controllers[0] = &controller;
+        const Property* board = game.board->squares;
+        GameResult result = playGame(&game, board, DEFAULT_TURN_LIMIT);
+        
+        totalTurns += result.turns;
+        if (result.winner != -1) {
+            wins[result.winner]++;
+        } else {
+            leads[netWorth(&game, board, 0) >= netWorth(&game, board, 1) ? 0 : 1]++;
+        }
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    releaseMctsBot(&bot);
+    
+    cout << "MCTS match: " << numGames << " games (seed " << seed << ") in " << seconds << "s, "
+         << budgetMs << " ms per decision on " << bot.config.threads << " threads\n";
+    cout << "Search bot: " << wins[0] << " wins, " << leads[0] << " ahead at the turn limit\n";
+    cout << "Basic bot:  " << wins[1] << " wins, " << leads[1] << " ahead at the turn limit\n";
+    if (numGames > 0) {
+        cout << "Average turns: " << (totalTurns / numGames) << "\n";
+    }
+    if (bot.stats.decisions > 0) {
+        cout << "Decisions: " << bot.stats.decisions << ", average "
+             << (bot.stats.totalSeconds * 1000 / bot.stats.decisions) << " ms, max "
+             << (bot.stats.maxSeconds * 1000) << " ms, "
+             << (bot.stats.iterations / bot.stats.decisions) << " iterations and "
+             << (bot.stats.nodes / bot.stats.decisions) << " tree nodes per decision\n";
+    }
+}
@@ -0,0 +1,83 @@
+#ifndef MCTS_H
+#define MCTS_H
+
+#include "simulation.h"
+
+// Monte Carlo tree search bot. Each buy, build and jail decision is
+// searched on copies of the game. An iteration plays on from the decision
+// with fresh dice: while it is in the tree, the bot's own decisions are
+// picked by UCT from the statistics there; the first decision it reaches
+// that the tree doesn't have yet is added as a new node, and from there
+// basic bots play out the rest. The result is backed up along the path.
+// The other players are basic bots throughout, and since every iteration
+// rolls different dice, a node stands for the bot's answers that led to
+// it (open loop) rather than for one position.
+//
+// A build decision is answered with a whole plan, some number of houses
+// on one group, which the bot then carries out a house per chooseBuild.
+//
+// Search threads run root parallel: each grows its own tree from the same
+// root, and the root visit counts are summed at the end. The threads are
+// started by the bot's first search and wait between decisions until
+// releaseMctsBot.
+//
+// GameState is a flat struct with the board and names behind pointers,
+// so a copy for an iteration is one memcpy of a few hundred bytes.
+const int MCTS_DEFAULT_BUDGET_MS = 40;
+const int MCTS_DEFAULT_THREADS = 1;
+const int MCTS_ROLLOUT_TURNS = 100;  // turns played out after a decision
+const double MCTS_EXPLORATION = 0.5; // UCT exploration constant
+const int MCTS_CLOCK_INTERVAL = 8;   // iterations between deadline checks
+const int MCTS_MAX_NODES = 50000;    // per search thread; the tree stops growing there
+// No answer, or per group up to one house a square, whole rounds and the most affordable
+const int MAX_MCTS_ANSWERS = 1 + MAX_BOARD_SIZE + NUM_COLORS * (HOTEL + 1);
+
+struct MctsConfig {
+    int budgetMs;      // time per decision
+    int maxIterations; // per decision over all threads, 0 for no limit
+    int threads;
+    int rolloutTurns;
+    unsigned long long seed;
+};
+
+// Totals over every decision the bot has searched
+struct MctsStats {
+    long long decisions;
+    long long iterations;
+    long long nodes;
+    double totalSeconds;
+    double maxSeconds;
+};
+
+// A build plan being carried out: housesLeft more houses on group color
+struct MctsBuildPlan {
+    bool active;
+    int player;
+    int color;
+    int housesLeft;
+    int money; // the player's money expected at the next chooseBuild; anything else ends the plan
+};
+
+struct MctsPool;
+
+// Controller context. One bot must not be used by games running at the
+// same time on different threads, since the stats and plan aren't locked.
+struct MctsBot {
+    MctsConfig config;
+    MctsStats stats;
+    MctsBuildPlan plan;
+    MctsPool* pool; // search threads, null until the first search
+};
+
+// Bot used for computer players in console games
+extern MctsBot DEFAULT_MCTS_BOT;
+extern PlayerController MCTS_BOT;
+
+// Function declarations
+void initializeMctsBot(MctsBot*, int, int, unsigned long long);
+void releaseMctsBot(MctsBot*);
+PlayerController mctsController(MctsBot*);
+int chooseMctsAnswer(const GameState*, const Property[], int, const int[], int, MctsBot*);
+void runMctsMatch(int, int, int, unsigned long long);
+
+#endif
@@ -1,265 +1,93 @@
 #include "monopoly.h"
+#include "board.h"
+#include "savefile.h"
+#include "journal.h"
+#include "events.h"
+#include "turn.h"
+#include "mcts.h"
+#include "profile.h"
+#include "liquidation.h"
 
-// Main function
-int main() {
-    srand(static_cast<unsigned int>(time(0)));
-    
-    Property board[BOARD_SIZE];
-    GameState gameState;
-    gameState.board = board;
-    char choice;
-    bool exitProgram = false;
-    
-    while (!exitProgram) {
-        cout << "=== Welcome to Monopoly! ===\n\n";
-        cout << "1. Load Saved Game\n";
-        cout << "2. Start New Game\n";
-        cout << "3. Exit\n";
-        cout << "Choose an option (1-3): ";
-        cin >> choice;
-        
-        switch (choice) {
-            case '1': {
-                if (!loadGame(&gameState, board)) {
-                    cout << "Would you like to start a new game instead? (y/n): ";
-                    cin >> choice;
-                    if (choice != 'y' && choice != 'Y') {
-                        continue;  // Go back to main menu
-                    }
-                    initializeBoard(board);
-                    initializeCards(&gameState);
-                    initializePlayers(&gameState);
-                }
-                
-                gameState.gameOver = false;  // Reset game over flag
-                // Game loop
-                while (!gameState.gameOver) {
-                    displayGameState(&gameState, board);
-                    processPlayerTurn(&gameState, board);
-                    
-                    if (checkWinCondition(&gameState)) {
-                        gameState.gameOver = true;
-                        continue;
-                    }
-                    
-                    cout << "\nContinue playing? (y/n): ";
-                    cin >> choice;
-                    if (choice != 'y' && choice != 'Y') {
-                        cout << "Would you like to save the game? (y/n): ";
-                        cin >> choice;
-                        if (choice == 'y' || choice == 'Y') {
-                            saveGame(&gameState, board);
-                        }
-                        break;
-                    }
-                }
-                break;
-            }
-            
-            case '2': {
-                // Initialize new game
-                initializeBoard(board);
-                initializeCards(&gameState);
-                initializePlayers(&gameState);
-                
-                gameState.gameOver = false;  // Reset game over flag
-                // Game loop
-                while (!gameState.gameOver) {
-                    displayGameState(&gameState, board);
-                    processPlayerTurn(&gameState, board);
-                    
-                    if (checkWinCondition(&gameState)) {
-                        gameState.gameOver = true;
-                        continue;
-                    }
-                    
-                    cout << "\nContinue playing? (y/n): ";
-                    cin >> choice;
-                    if (choice != 'y' && choice != 'Y') {
-                        cout << "Would you like to save the game? (y/n): ";
-                        cin >> choice;
-                        if (choice == 'y' || choice == 'Y') {
-                            saveGame(&gameState, board);
-                        }
-                        break;
-                    }
-                }
-                break;
-            }
-            
-            case '3': {
-                exitProgram = true;
-                cout << "\nThanks for playing Monopoly!\n";
-                break;
-            }
-            
-            default: {
-                cout << "Invalid choice. Please try again.\n\n";
-                cin.clear();
-                cin.ignore(10000, '\n');
-                break;
-            }
-        }
-        
-        if (!exitProgram && !gameState.gameOver) {
-            cout << "\nWould you like to return to the main menu? (y/n): ";
-            cin >> choice;
-            if (choice != 'y' && choice != 'Y') {
-                exitProgram = true;
-                cout << "\nThanks for playing Monopoly!\n";
-            }
-            cout << "\n";
-        }
+// New games are dealt onto this board (see main.cpp for --board)
+const Board* activeBoard = &STANDARD_BOARD;
+
+// Where a card moves a player standing on square, or square itself if it
+// doesn't move them. Go to Jail is left to the caller.
+int cardDestination(const Board* board, const Card& card, int square) {
+    SquareMask targets;
+    switch (card.actionType) {
+        case CARD_MOVE_TO:
+            return card.actionValue;
+        case CARD_MOVE_BY:
+            return (square + card.actionValue + board->size) % board->size;
+        case CARD_NEAREST_RAILROAD:
+            targets = board->railroadMask;
+            break;
+        case CARD_NEAREST_UTILITY:
+            targets = board->utilityMask;
+            break;
+        default:
+            return square;
     }
-    
-    return 0;
+    if (targets == 0) {
+        return square;
+    }
+    // The first target after square, going round past GO if need be.
+    // Two shifts, so the last square of a full board doesn't shift by 64.
+    SquareMask ahead = targets & (~0ULL << square << 1);
+    return __builtin_ctzll(ahead != 0 ? ahead : targets);
 }
+
 // Initialization Functions
-void initializeBoard(Property board[]) {
-    for (int i = 0; i < BOARD_SIZE; i++) {
-        strcpy(board[i].name, "");
-        board[i].type = 0;
-        board[i].color = -1;
-        board[i].price = 0;
-        board[i].baseRent = 0;
-        board[i].owner = -1;
-        board[i].mortgaged = false;
-    }
+void initializeBoard(GameState* game, const Board* board) {
+    memcpy(game->squares, INITIAL_SQUARES.squares, sizeof(INITIAL_SQUARES.squares));
+    game->board = board;
+}
 
-    // GO
-    strcpy(board[0].name, "GO");
-    board[0].type = 0;  // SPECIAL
-    
-    // Brown Properties
-    strcpy(board[1].name, "Mediterranean Avenue");
-    board[1].type = 1;
-    board[1].color = 0;
-    board[1].price = 60;
-    
-    strcpy(board[2].name, "Community Chest");
-    board[2].type = 5;
-    
-    strcpy(board[3].name, "Baltic Avenue");
-    board[3].type = 1;
-    board[3].color = 0;
-    board[3].price = 60;
-    
-    strcpy(board[4].name, "Income Tax");
-    board[4].type = 3;
-    board[4].price = 200;
-    
-    strcpy(board[5].name, "Reading Railroad");
-    board[5].type = 2;
-    board[5].price = 200;
-    
-    strcpy(board[6].name, "Oriental Avenue");
-    board[6].type = 1;
-    board[6].color = 1;
-    board[6].price = 100;
-    
-    strcpy(board[7].name, "Chance");
-    board[7].type = 4;
-    
-    strcpy(board[8].name, "Vermont Avenue");
-    board[8].type = 1;
-    board[8].color = 1;
-    board[8].price = 100;
-    
-    strcpy(board[9].name, "Connecticut Avenue");
-    board[9].type = 1;
-    board[9].color = 1;
-    board[9].price = 120;
-    
-    strcpy(board[10].name, "Jail");
-    board[10].type = 0;
-    
-    strcpy(board[11].name, "St. Charles Place");
-    board[11].type = 1;
-    board[11].color = 2;
-    board[11].price = 140;
-    
-    strcpy(board[12].name, "Electric Company");
-    board[12].type = 3;
-    board[12].price = 150;
-    
-    strcpy(board[13].name, "States Avenue");
-    board[13].type = 1;
-    board[13].color = 2;
-    board[13].price = 140;
-    
-    strcpy(board[14].name, "Virginia Avenue");
-    board[14].type = 1;
-    board[14].color = 2;
-    board[14].price = 160;
-    
-    strcpy(board[15].name, "Pennsylvania Railroad");
-    board[15].type = 2;
-    board[15].price = 200;
-    
-    // Continue with the rest of the properties...
-    
-    strcpy(board[20].name, "Free Parking");
-    board[20].type = 0;
-    
-    strcpy(board[30].name, "Go to Jail");
-    board[30].type = 0;
-    
-    // Initialize all property values
-    for (int i = 0; i < BOARD_SIZE; i++) {
-        if (board[i].type == 1) {  // Regular properties
-            board[i].baseRent = board[i].price / 10;
-            board[i].rentWithSet = board[i].baseRent * 2;
-            board[i].houseCost = board[i].price / 2;
-            board[i].houses = 0;
-            
-            // Set house rents
-            for (int j = 0; j < 4; j++) {
-                board[i].rentWithHouses[j] = board[i].baseRent * (j + 3);
-            }
-            board[i].rentWithHotel = board[i].baseRent * 12;
+// Shuffles both decks with the game's dice generator, so the deal is as
+// reproducible as the rolls. Seed the dice first.
+void initializeCards(GameState* game) {
+    for (int deck = 0; deck < NUM_DECKS; deck++) {
+        unsigned char* order = game->deckOrder[deck];
+        for (int i = 0; i < DECK_SIZE; i++) {
+            order[i] = i;
         }
-        else if (board[i].type == 2) {  // Railroads
-            board[i].baseRent = 25;
+        // Fisher-Yates; multiply-shift maps a draw onto 0..i with a bias
+        // far below anything a game could show
+        for (int i = DECK_SIZE - 1; i > 0; i--) {
+            unsigned long long draw = nextRandom(&game->dice.rng);
+            int j = static_cast<int>((static_cast<unsigned __int128>(draw) * (i + 1)) >> 64);
+            unsigned char card = order[i];
+            order[i] = order[j];
+            order[j] = card;
         }
+        game->deckIndex[deck] = 0;
     }
 }
 
-void initializeCards(GameState* game) {
-    // Initialize Chance Cards
-    strcpy(game->chanceCards[0].text, "Advance to GO");
-    game->chanceCards[0].actionType = 0;
-    game->chanceCards[0].actionValue = 0;
-
-    strcpy(game->chanceCards[1].text, "Bank pays dividend of $50");
-    game->chanceCards[1].actionType = 1;
-    game->chanceCards[1].actionValue = 50;
-
-    strcpy(game->chanceCards[2].text, "Pay poor tax of $15");
-    game->chanceCards[2].actionType = 1;
-    game->chanceCards[2].actionValue = -15;
-
-    strcpy(game->chanceCards[3].text, "Get Out of Jail Free");
-    game->chanceCards[3].actionType = 2;
-    game->chanceCards[3].actionValue = 0;
-
-    // Initialize Community Chest Cards
-    strcpy(game->communityCards[0].text, "Bank error in your favor - Collect $200");
-    game->communityCards[0].actionType = 1;
-    game->communityCards[0].actionValue = 200;
-
-    strcpy(game->communityCards[1].text, "Doctor's fees - Pay $50");
-    game->communityCards[1].actionType = 1;
-    game->communityCards[1].actionValue = -50;
-
-    strcpy(game->communityCards[2].text, "Get Out of Jail Free");
-    game->communityCards[2].actionType = 2;
-    game->communityCards[2].actionValue = 0;
+void initializePlayer(Player* player, int startingMoney) {
+    player->money = startingMoney;
+    player->position = 0;
+    player->inJail = false;
+    player->jailTurns = 0;
+    player->bankrupt = false;
+    player->computer = false;
+    player->getOutOfJailCards = 0;
+    player->propertyCount = 0;
+    
+    for (int j = 0; j < MAX_BOARD_SIZE; j++) {
+        player->ownedProperties[j] = -1;
+    }
+}
 
-    game->chanceIndex = 0;
-    game->communityIndex = 0;
+// Computer players get the search bot, everyone else the console
+void assignConsoleControllers(GameState* game) {
+    for (int i = 0; i < game->numPlayers; i++) {
+        game->controllers[i] = game->players[i].computer ? &MCTS_BOT : &CONSOLE_PLAYER;
+    }
 }
 
-void initializePlayers(GameState* game) {
+void initializePlayers(GameState* game, PlayerNames* names) {
     cout << "Enter number of players (2-4): ";
     cin >> game->numPlayers;
     
@@ -272,81 +100,85 @@ void initializePlayers(GameState* game) {
     
     for (int i = 0; i < game->numPlayers; i++) {
         cout << "Enter name for Player " << (i + 1) << ": ";
-        cin.getline(game->players[i].name, MAX_NAME_LENGTH);
+        cin.getline(names->name[i], MAX_NAME_LENGTH);
+        initializePlayer(&game->players[i], game->board->startingMoney);
         
-        game->players[i].money = STARTING_MONEY;
-        game->players[i].position = 0;
-        game->players[i].inJail = false;
-        game->players[i].jailTurns = 0;
-        game->players[i].bankrupt = false;
-        game->players[i].getOutOfJailCards = 0;
-        game->players[i].propertyCount = 0;
-        
-        for (int j = 0; j < BOARD_SIZE; j++) {
-            game->players[i].ownedProperties[j] = -1;
-        }
+        char choice;
+        cout << "Is " << names->name[i] << " a computer player? (y/n): ";
+        cin >> choice;
+        cin.ignore(10000, '\n');
+        game->players[i].computer = (choice == 'y' || choice == 'Y');
     }
 
+    assignConsoleControllers(game);
+    game->names = names;
     game->currentPlayer = 0;
     game->gameOver = false;
+    game->outputLevel = OUTPUT_VERBOSE;
+    startTurn(game);
 }
 
-void rollDice(int* dice1, int* dice2) {
-    *dice1 = (rand() % 6) + 1;
-    *dice2 = (rand() % 6) + 1;
+// Each game carries its own dice, so games running on different threads
+// never share a generator
+void rollDice(GameState* game, int* dice1, int* dice2) {
+    int pair = nextDicePair(&game->dice);
+    journalEvent(game, JOURNAL_ROLL, game->currentPlayer, 0, pair, 0);
+    *dice1 = pair >> 4;
+    *dice2 = pair & 0xF;
 }
 
 bool isDouble(int dice1, int dice2) {
     return dice1 == dice2;
 }
 // Movement and Property Handling Functions
-void movePlayer(GameState* game, Property board[], int totalSpaces) {
+void movePlayer(GameState* game, const Property board[], int totalSpaces) {
     Player* currentPlayer = &game->players[game->currentPlayer];
     
-    // Calculate new position
-    int newPosition = (currentPlayer->position + totalSpaces) % BOARD_SIZE;
+    // Calculate new position. Boards are bigger than any roll, so one lap at most.
+    int newPosition = currentPlayer->position + totalSpaces;
+    if (newPosition >= game->board->size) {
+        newPosition -= game->board->size;
+    }
     
     // Check if passing GO
+    int salary = 0;
     if (newPosition < currentPlayer->position) {
-        currentPlayer->money += 200;
-        cout << currentPlayer->name << " passed GO! Collect $200\n";
+        salary = game->board->goSalary;
+        currentPlayer->money += salary;
+        emitEvent(game, EVENT_PASS_GO, game->currentPlayer);
     }
     
     currentPlayer->position = newPosition;
+    journalEvent(game, JOURNAL_MOVE, game->currentPlayer, newPosition, 0, salary);
     
-    // Add error checking for property names
-    if (strlen(board[newPosition].name) > 0) {
-        cout << currentPlayer->name << " landed on " << board[newPosition].name << endl;
-    } else {
-        cout << currentPlayer->name << " landed on space " << newPosition << endl;
-    }
+    emitEvent(game, EVENT_LAND, game->currentPlayer, newPosition);
 }
 
 int calculateRent(const Property& property, const GameState* game, int diceRoll, int propertyIndex) {
-    if (property.mortgaged) return 0;
+    PROFILE_SCOPE(PROFILE_CALCULATE_RENT);
+    const SquareState* state = &game->squares[propertyIndex];
+    
+    if (state->mortgaged) return 0;
     
     switch (property.type) {
         case 1: // REGULAR_PROPERTY
-            if (property.houses == 0) {
-                // Pass the board parameter directly instead of using game->board
-                if (hasMonopoly(game, game->board, property.owner, propertyIndex)) {
+            if (state->houses == 0) {
+                if (hasMonopoly(game, game->board->squares, state->owner, propertyIndex)) {
                     return property.rentWithSet;
                 }
                 return property.baseRent;
-            } else if (property.houses == HOTEL) {
+            } else if (state->houses == HOTEL) {
                 return property.rentWithHotel;
             } else {
-                return property.rentWithHouses[property.houses - 1];
+                return property.rentWithHouses[state->houses - 1];
             }
             
         case 2: // RAILROAD
-            // Pass board parameter directly
             return property.baseRent * 
-                   (1 << (countRailroadsOwned(game, game->board, property.owner) - 1));
+                   (1 << (countRailroadsOwned(game, game->board->squares, state->owner) - 1));
             
         case 3: // UTILITY
-            // Pass board parameter directly
-            if (countUtilitiesOwned(game, game->board, property.owner) == 1) {
+            if (countUtilitiesOwned(game, game->board->squares, state->owner) == 1) {
                 return diceRoll * 4;
             } else {
                 return diceRoll * 10;
@@ -358,15 +190,15 @@ int calculateRent(const Property& property, const GameState* game, int diceRoll,
 }
 
 // Display Functions
-void displayProperty(const Property& prop) {
+void displayProperty(const Property& prop, const SquareState& state) {
     cout << "\nProperty: " << prop.name;
     
     if (prop.type == 1) { // REGULAR_PROPERTY
         cout << "\nPrice: $" << prop.price
              << "\nRent: $" << prop.baseRent
              << "\nRent with set: $" << prop.rentWithSet
-             << "\nHouses: " << prop.houses
-             << "\nMortgaged: " << (prop.mortgaged ? "Yes" : "No");
+             << "\nHouses: " << static_cast<int>(state.houses)
+             << "\nMortgaged: " << (state.mortgaged ? "Yes" : "No");
     } else if (prop.type == 2) { // RAILROAD
         cout << "\nPrice: $" << prop.price
              << "\nBase Rent: $" << prop.baseRent;
@@ -374,23 +206,19 @@ void displayProperty(const Property& prop) {
         cout << "\nPrice: $" << prop.price
              << "\nRent is 4x or 10x dice roll";
     }
-    cout << endl;
+    cout << '\n';
 }
 
 void displayPlayerProperties(const GameState* game, const Property board[], int playerNum) {
     const Player* player = &game->players[playerNum];
-    cout << "\nProperties owned by " << player->name << ":\n";
+    cout << "\nProperties owned by " << playerName(game, playerNum) << ":\n";
     
-    bool hasProperties = false;
     for (int i = 0; i < player->propertyCount; i++) {
-        if (player->ownedProperties[i] != -1) {
-            hasProperties = true;
-            cout << i + 1 << ". ";
-            displayProperty(board[player->ownedProperties[i]]);
-        }
+        cout << i + 1 << ". ";
+        displayProperty(board[player->ownedProperties[i]], game->squares[player->ownedProperties[i]]);
     }
     
-    if (!hasProperties) {
+    if (player->propertyCount == 0) {
         cout << "No properties owned.\n";
     }
 }
@@ -399,10 +227,10 @@ void displayGameState(const GameState* game, const Property board[]) {
     cout << "\n=== Current Game State ===\n";
     for (int i = 0; i < game->numPlayers; i++) {
         const Player* player = &game->players[i];
-        cout << player->name 
+        cout << playerName(game, i)
              << "\nMoney: $" << player->money
              << "\nPosition: " << board[player->position].name
-             << "\nGet Out of Jail Cards: " << player->getOutOfJailCards
+             << "\nGet Out of Jail Cards: " << static_cast<int>(player->getOutOfJailCards)
              << "\nIn Jail: " << (player->inJail ? "Yes" : "No")
              << "\nBankrupt: " << (player->bankrupt ? "Yes" : "No")
              << "\n\n";
@@ -424,84 +252,158 @@ void displayMenu() {
 }
 
 // Property Ownership Functions
-bool hasMonopoly(const GameState* game, const Property board[], int playerNum, int propertyIndex) {
-    int color = board[propertyIndex].color;
-    int colorCount = 0;
-    int playerCount = 0;
-    
-    // Count properties of this color
-    for (int i = 0; i < BOARD_SIZE; i++) {
-        if (board[i].color == color) {
-            colorCount++;
-            if (board[i].owner == playerNum) {
-                playerCount++;
-            }
+
+// Rebuilds the ownership index from scratch: new games and loaded saves
+void rebuildOwnershipIndex(GameState* game, const Property board[]) {
+    memset(game->ownedMasks, 0, sizeof(game->ownedMasks));
+    memset(game->houseMasks, 0, sizeof(game->houseMasks));
+    game->mortgagedMask = 0;
+    
+    for (int i = 0; i < game->board->size; i++) {
+        SquareState* state = &game->squares[i];
+        
+        state->slot = 0;
+        if (state->owner != -1) {
+            game->ownedMasks[state->owner] |= squareBit(i);
+        }
+        if (state->mortgaged) {
+            game->mortgagedMask |= squareBit(i);
+        }
+        for (int k = 0; k < state->houses; k++) {
+            game->houseMasks[k] |= squareBit(i);
         }
     }
     
-    return (colorCount > 0 && colorCount == playerCount);
+    for (int i = 0; i < game->numPlayers; i++) {
+        const Player* player = &game->players[i];
+        for (int j = 0; j < player->propertyCount; j++) {
+            game->squares[player->ownedProperties[j]].slot = j;
+        }
+    }
 }
 
-int countRailroadsOwned(const GameState* game, const Property board[], int playerNum) {
-    int count = 0;
-    for (int i = 0; i < BOARD_SIZE; i++) {
-        if (board[i].type == 2 && board[i].owner == playerNum) { // RAILROAD
-            count++;
-        }
+// Every change of owner goes through here so the index and the holdings
+// lists stay exact. The square leaves the old owner's list by swapping
+// in that list's last entry and joins the end of the new owner's list.
+void setPropertyOwner(GameState* game, const Property board[], int propertyIndex, int newOwner) {
+    SquareState* state = &game->squares[propertyIndex];
+    int oldOwner = state->owner;
+    
+    if (oldOwner == newOwner) {
+        return;
     }
-    return count;
+    
+    if (oldOwner != -1) {
+        Player* player = &game->players[oldOwner];
+        int last = player->ownedProperties[--player->propertyCount];
+        player->ownedProperties[state->slot] = last;
+        game->squares[last].slot = state->slot;
+        player->ownedProperties[player->propertyCount] = -1;
+        game->ownedMasks[oldOwner] &= ~squareBit(propertyIndex);
+    }
+    state->slot = 0;
+    if (newOwner != -1) {
+        Player* player = &game->players[newOwner];
+        state->slot = player->propertyCount;
+        player->ownedProperties[player->propertyCount++] = propertyIndex;
+        game->ownedMasks[newOwner] |= squareBit(propertyIndex);
+    }
+    state->owner = newOwner;
 }
 
-int countUtilitiesOwned(const GameState* game, const Property board[], int playerNum) {
-    int count = 0;
-    for (int i = 0; i < BOARD_SIZE; i++) {
-        if (board[i].type == 3 && board[i].owner == playerNum) { // UTILITY
-            count++;
+// Likewise for houses: houseMasks[k] holds the squares with more than k
+void setHouses(GameState* game, int propertyIndex, int houses) {
+    SquareMask bit = squareBit(propertyIndex);
+    
+    for (int k = 0; k < HOTEL; k++) {
+        if (k < houses) {
+            game->houseMasks[k] |= bit;
+        } else {
+            game->houseMasks[k] &= ~bit;
         }
     }
-    return count;
+    game->squares[propertyIndex].houses = houses;
+}
+
+void setMortgaged(GameState* game, int propertyIndex, bool mortgaged) {
+    if (mortgaged) {
+        game->mortgagedMask |= squareBit(propertyIndex);
+    } else {
+        game->mortgagedMask &= ~squareBit(propertyIndex);
+    }
+    game->squares[propertyIndex].mortgaged = mortgaged;
+}
+
+bool hasMonopoly(const GameState* game, const Property board[], int playerNum, int propertyIndex) {
+    int color = board[propertyIndex].color;
+    
+    if (playerNum < 0 || color < 0) {
+        return false;
+    }
+    SquareMask group = game->board->colorMasks[color];
+    return (game->ownedMasks[playerNum] & group) == group;
+}
+
+int countRailroadsOwned(const GameState* game, const Property board[], int playerNum) {
+    return countSquares(game->ownedMasks[playerNum] & game->board->railroadMask);
+}
+
+int countUtilitiesOwned(const GameState* game, const Property board[], int playerNum) {
+    return countSquares(game->ownedMasks[playerNum] & game->board->utilityMask);
 }
 
 bool canAffordProperty(const Player& player, const Property& property) {
     return player.money >= property.price;
 }
 
-void handleProperty(GameState* game, Property board[], int diceRoll) {
+// Pays rent for the square the current player is on. Returns true if the
+// square is for sale and the player can afford it; the turn then asks
+// whether to buy it (see turn.cpp).
+bool handleProperty(GameState* game, const Property board[], int diceRoll) {
+    PROFILE_SCOPE(PROFILE_HANDLE_PROPERTY);
     Player* currentPlayer = &game->players[game->currentPlayer];
-    Property* currentProperty = &board[currentPlayer->position];
+    const Property* currentProperty = &board[currentPlayer->position];
+    int owner = game->squares[currentPlayer->position].owner;
     
     if (currentProperty->type == 1 || // REGULAR_PROPERTY
         currentProperty->type == 2 || // RAILROAD
         currentProperty->type == 3) { // UTILITY
         
-        if (currentProperty->owner == -1) {
+        if (owner == -1) {
             if (canAffordProperty(*currentPlayer, *currentProperty)) {
-                char choice;
-                cout << "Would you like to buy " << currentProperty->name 
-                     << " for $" << currentProperty->price << "? (y/n): ";
-                cin >> choice;
-                
-                if (choice == 'y' || choice == 'Y') {
-                    currentPlayer->money -= currentProperty->price;
-                    currentProperty->owner = game->currentPlayer;
-                    currentPlayer->ownedProperties[currentPlayer->propertyCount++] = currentPlayer->position;
-                    cout << "Property purchased successfully!\n";
-                }
-            } else {
-                cout << "Not enough money to purchase this property.\n";
+                return true;
             }
-        } else if (currentProperty->owner != game->currentPlayer) {
+            emitRefusal(game, REFUSED_CANNOT_AFFORD_PROPERTY);
+        } else if (owner != game->currentPlayer) {
             int rentAmount = calculateRent(*currentProperty, game, diceRoll, currentPlayer->position);
+            if (rentAmount > 0 && game->turn.cardRent == CARD_NEAREST_RAILROAD) {
+                rentAmount *= 2;
+            } else if (rentAmount > 0 && game->turn.cardRent == CARD_NEAREST_UTILITY) {
+                rentAmount = diceRoll * 10;
+            }
             currentPlayer->money -= rentAmount;
-            game->players[currentProperty->owner].money += rentAmount;
-            cout << currentPlayer->name << " paid $" << rentAmount << " in rent to " 
-                 << game->players[currentProperty->owner].name << endl;
+            game->players[owner].money += rentAmount;
+            journalEvent(game, JOURNAL_RENT, game->currentPlayer, currentPlayer->position, owner, rentAmount);
+            emitEvent(game, EVENT_RENT, game->currentPlayer, currentPlayer->position, rentAmount, owner);
         }
     }
+    return false;
+}
+
+void buyProperty(GameState* game, const Property board[], int propertyIndex) {
+    Player* currentPlayer = &game->players[game->currentPlayer];
+    int price = board[propertyIndex].price;
+    
+    currentPlayer->money -= price;
+    setPropertyOwner(game, board, propertyIndex, game->currentPlayer);
+    journalEvent(game, JOURNAL_PURCHASE, game->currentPlayer, propertyIndex, 0, price);
+    emitEvent(game, EVENT_PURCHASE, game->currentPlayer, propertyIndex, price);
 }
+
 // Trading and Property Management Functions
 
-void tradeProperties(GameState* game, Property board[]) {
+void tradeProperties(GameState* game, const Property board[]) {
+    PROFILE_SCOPE(PROFILE_TRADE_PROPERTIES);
     int player1 = game->currentPlayer;
     cout << "Enter player number to trade with (";
     for (int i = 0; i < game->numPlayers; i++) {
@@ -521,341 +423,395 @@ void tradeProperties(GameState* game, Property board[]) {
     // Display properties of both players
     cout << "\nYour properties:\n";
     displayPlayerProperties(game, board, player1);
-    cout << "\n" << game->players[player2].name << "'s properties:\n";
+    cout << "\n" << playerName(game, player2) << "'s properties:\n";
     displayPlayerProperties(game, board, player2);
     
     // Get property selections
-    int prop1 = -1, prop2 = -1;
-    int money1 = 0, money2 = 0;
+    TradeOffer offer;
+    offer.fromPlayer = player1;
+    offer.toPlayer = player2;
+    offer.offeredProperty = -1;
+    offer.requestedProperty = -1;
+    offer.offeredMoney = 0;
+    offer.requestedMoney = 0;
     
     cout << "\nEnter property number to offer (0 for none): ";
-    cin >> prop1;
-    if (prop1 > 0) prop1--;
+    cin >> offer.offeredProperty;
+    offer.offeredProperty--;
     
     cout << "Enter amount of money to offer (0 for none): $";
-    cin >> money1;
+    cin >> offer.offeredMoney;
     
     cout << "\nEnter property number to receive (0 for none): ";
-    cin >> prop2;
-    if (prop2 > 0) prop2--;
+    cin >> offer.requestedProperty;
+    offer.requestedProperty--;
     
     cout << "Enter amount of money to receive (0 for none): $";
-    cin >> money2;
+    cin >> offer.requestedMoney;
     
     // Validate selections
-    if ((prop1 >= 0 && (prop1 >= game->players[player1].propertyCount || 
-        game->players[player1].ownedProperties[prop1] == -1)) ||
-        (prop2 >= 0 && (prop2 >= game->players[player2].propertyCount || 
-        game->players[player2].ownedProperties[prop2] == -1))) {
+    if (!isValidTradeSelection(game, &offer)) {
         cout << "Invalid property selection!\n";
         return;
     }
     
     // Check if players have enough money
-    if (game->players[player1].money < money1 || 
-        game->players[player2].money < money2) {
+    if (!isAffordableTrade(game, &offer)) {
         cout << "One or both players don't have enough money!\n";
         return;
     }
     
     // Ask other player to accept
-    cout << "\n" << game->players[player2].name << ", do you accept this trade? (y/n): ";
-    char choice;
-    cin >> choice;
-    
-    if (choice == 'y' || choice == 'Y') {
-        // Execute trade
-        if (prop1 >= 0) {
-            int propertyIndex = game->players[player1].ownedProperties[prop1];
-            board[propertyIndex].owner = player2;
-            // Add to player2's properties
-            game->players[player2].ownedProperties[game->players[player2].propertyCount++] = propertyIndex;
-            // Remove from player1's properties
-            game->players[player1].ownedProperties[prop1] = -1;
-        }
-        
-        if (prop2 >= 0) {
-            int propertyIndex = game->players[player2].ownedProperties[prop2];
-            board[propertyIndex].owner = player1;
-            // Add to player1's properties
-            game->players[player1].ownedProperties[game->players[player1].propertyCount++] = propertyIndex;
-            // Remove from player2's properties
-            game->players[player2].ownedProperties[prop2] = -1;
-        }
-        
-        // Exchange money
-        game->players[player1].money -= money1;
-        game->players[player2].money += money1;
-        game->players[player2].money -= money2;
-        game->players[player1].money += money2;
-        
+    PlayerController* other = game->controllers[player2];
+    if (other->acceptTrade(game, board, &offer, other->context)) {
+        executeTrade(game, board, &offer);
         cout << "Trade completed successfully!\n";
     } else {
         cout << "Trade rejected.\n";
     }
 }
 
-void mortgageProperty(GameState* game, Property board[], int propertyIndex) {
+bool isValidTradeSelection(const GameState* game, const TradeOffer* offer) {
+    const Player* player1 = &game->players[offer->fromPlayer];
+    const Player* player2 = &game->players[offer->toPlayer];
+    
+    return offer->offeredProperty < player1->propertyCount &&
+           offer->requestedProperty < player2->propertyCount;
+}
+
+bool isAffordableTrade(const GameState* game, const TradeOffer* offer) {
+    return offer->offeredMoney >= 0 && offer->requestedMoney >= 0 &&
+           game->players[offer->fromPlayer].money >= offer->offeredMoney &&
+           game->players[offer->toPlayer].money >= offer->requestedMoney;
+}
+
+bool executeTrade(GameState* game, const Property board[], const TradeOffer* offer) {
+    if (!isValidTradeSelection(game, offer) || !isAffordableTrade(game, offer)) {
+        return false;
+    }
+    
+    Player* player1 = &game->players[offer->fromPlayer];
+    Player* player2 = &game->players[offer->toPlayer];
+    journalEvent(game, JOURNAL_TRADE, offer->fromPlayer | (offer->toPlayer << 4),
+                 offer->offeredProperty, offer->requestedProperty,
+                 offer->offeredMoney - offer->requestedMoney);
+    emitEvent(game, EVENT_TRADE, offer->fromPlayer, 0, 0, offer->toPlayer);
+    
+    // Look up both squares before either transfer moves list entries
+    int offeredIndex = offer->offeredProperty >= 0 ? player1->ownedProperties[offer->offeredProperty] : -1;
+    int requestedIndex = offer->requestedProperty >= 0 ? player2->ownedProperties[offer->requestedProperty] : -1;
+    
+    if (offeredIndex != -1) {
+        setPropertyOwner(game, board, offeredIndex, offer->toPlayer);
+    }
+    if (requestedIndex != -1) {
+        setPropertyOwner(game, board, requestedIndex, offer->fromPlayer);
+    }
+    
+    // Exchange money
+    player1->money -= offer->offeredMoney;
+    player2->money += offer->offeredMoney;
+    player2->money -= offer->requestedMoney;
+    player1->money += offer->requestedMoney;
+    return true;
+}
+
+void mortgageProperty(GameState* game, const Property board[], int propertyIndex) {
     Player* currentPlayer = &game->players[game->currentPlayer];
-    Property* property = &board[propertyIndex];
+    const Property* property = &board[propertyIndex];
+    SquareState* state = &game->squares[propertyIndex];
     
-    if (property->owner != game->currentPlayer) {
-        cout << "You don't own this property!\n";
+    if (state->owner != game->currentPlayer) {
+        emitRefusal(game, REFUSED_NOT_OWNER);
         return;
     }
     
-    if (property->mortgaged) {
-        cout << "This property is already mortgaged!\n";
+    if (state->mortgaged) {
+        emitRefusal(game, REFUSED_ALREADY_MORTGAGED);
         return;
     }
     
-    if (property->houses > 0) {
-        cout << "You must sell all houses first!\n";
+    if (state->houses > 0) {
+        emitRefusal(game, REFUSED_HAS_HOUSES);
         return;
     }
     
-    property->mortgaged = true;
-    currentPlayer->money += property->price / 2;
-    cout << "Property mortgaged. Received $" << (property->price / 2) << endl;
+    setMortgaged(game, propertyIndex, true);
+    currentPlayer->money += property->mortgageValue;
+    journalEvent(game, JOURNAL_MORTGAGE, game->currentPlayer, propertyIndex, 1, property->mortgageValue);
+    emitEvent(game, EVENT_MORTGAGE, game->currentPlayer, propertyIndex, property->mortgageValue);
 }
 
-void unmortgageProperty(GameState* game, Property board[], int propertyIndex) {
+void unmortgageProperty(GameState* game, const Property board[], int propertyIndex) {
     Player* currentPlayer = &game->players[game->currentPlayer];
-    Property* property = &board[propertyIndex];
-    int unmortgageCost = (property->price / 2) * 1.1; // 10% interest
+    const Property* property = &board[propertyIndex];
+    SquareState* state = &game->squares[propertyIndex];
+    int unmortgageCost = property->unmortgageCost;
     
-    if (property->owner != game->currentPlayer) {
-        cout << "You don't own this property!\n";
+    if (state->owner != game->currentPlayer) {
+        emitRefusal(game, REFUSED_NOT_OWNER);
         return;
     }
     
-    if (!property->mortgaged) {
-        cout << "This property is not mortgaged!\n";
+    if (!state->mortgaged) {
+        emitRefusal(game, REFUSED_NOT_MORTGAGED);
         return;
     }
     
     if (currentPlayer->money < unmortgageCost) {
-        cout << "You don't have enough money to unmortgage this property!\n";
+        emitRefusal(game, REFUSED_CANNOT_AFFORD_UNMORTGAGE);
         return;
     }
     
-    property->mortgaged = false;
+    setMortgaged(game, propertyIndex, false);
     currentPlayer->money -= unmortgageCost;
-    cout << "Property unmortgaged. Paid $" << unmortgageCost << endl;
+    journalEvent(game, JOURNAL_MORTGAGE, game->currentPlayer, propertyIndex, 0, -unmortgageCost);
+    emitEvent(game, EVENT_UNMORTGAGE, game->currentPlayer, propertyIndex, unmortgageCost);
 }
 
-void buildHouse(GameState* game, Property board[], int propertyIndex) {
+void buildHouse(GameState* game, const Property board[], int propertyIndex) {
+    PROFILE_SCOPE(PROFILE_BUILD_HOUSE);
     Player* currentPlayer = &game->players[game->currentPlayer];
-    Property* property = &board[propertyIndex];
+    const Property* property = &board[propertyIndex];
+    SquareState* state = &game->squares[propertyIndex];
     
     if (property->type != 1) { // Not a REGULAR_PROPERTY
-        cout << "Can only build houses on regular properties!\n";
+        emitRefusal(game, REFUSED_NOT_BUILDABLE);
         return;
     }
     
     if (!hasMonopoly(game, board, game->currentPlayer, propertyIndex)) {
-        cout << "You need to own all properties of this color to build houses!\n";
+        emitRefusal(game, REFUSED_NO_MONOPOLY);
         return;
     }
     
-    if (property->houses >= HOTEL) {
-        cout << "Already has a hotel! Cannot build more.\n";
+    if (state->houses >= HOTEL) {
+        emitRefusal(game, REFUSED_HAS_HOTEL);
         return;
     }
     
     if (currentPlayer->money < property->houseCost) {
-        cout << "Not enough money to build a house!\n";
+        emitRefusal(game, REFUSED_CANNOT_AFFORD_HOUSE);
         return;
     }
     
-    // Check for even building
-    int color = property->color;
-    for (int i = 0; i < BOARD_SIZE; i++) {
-        if (board[i].color == color && board[i].houses < property->houses) {
-            cout << "Must build evenly across properties of the same color!\n";
-            return;
-        }
+    // No houses on a group with a mortgage, which also keeps them off
+    // mortgaged squares
+    SquareMask group = game->board->colorMasks[property->color];
+    if ((game->mortgagedMask & group) != 0) {
+        emitRefusal(game, REFUSED_MORTGAGED_GROUP);
+        return;
     }
     
-    property->houses++;
-    currentPlayer->money -= property->houseCost;
-    
-    if (property->houses == HOTEL) {
-        cout << "Built a hotel on " << property->name << endl;
-    } else {
-        cout << "Built house #" << property->houses << " on " << property->name << endl;
+    // Even building: every square in the group must already have as many
+    if (state->houses > 0 && (game->houseMasks[state->houses - 1] & group) != group) {
+        emitRefusal(game, REFUSED_UNEVEN_BUILD);
+        return;
     }
+    
+    setHouses(game, propertyIndex, state->houses + 1);
+    currentPlayer->money -= property->houseCost;
+    journalEvent(game, JOURNAL_BUILD, game->currentPlayer, propertyIndex, state->houses, -property->houseCost);
+    emitEvent(game, EVENT_BUILD, game->currentPlayer, propertyIndex, 0, state->houses);
 }
 
-void sellHouse(GameState* game, Property board[], int propertyIndex) {
+void sellHouse(GameState* game, const Property board[], int propertyIndex) {
     Player* currentPlayer = &game->players[game->currentPlayer];
-    Property* property = &board[propertyIndex];
+    const Property* property = &board[propertyIndex];
+    SquareState* state = &game->squares[propertyIndex];
     
-    if (property->owner != game->currentPlayer) {
-        cout << "You don't own this property!\n";
+    if (state->owner != game->currentPlayer) {
+        emitRefusal(game, REFUSED_NOT_OWNER);
         return;
     }
     
-    if (property->houses == 0) {
-        cout << "No houses to sell!\n";
+    if (state->houses == 0) {
+        emitRefusal(game, REFUSED_NO_HOUSES);
         return;
     }
     
-    // Check for even selling
-    int color = property->color;
-    for (int i = 0; i < BOARD_SIZE; i++) {
-        if (board[i].color == color && board[i].houses > property->houses) {
-            cout << "Must sell houses evenly across properties of the same color!\n";
-            return;
-        }
+    // Even selling: no square in the group may have more
+    SquareMask group = game->board->colorMasks[property->color];
+    if (state->houses < HOTEL && (game->houseMasks[state->houses] & group) != 0) {
+        emitRefusal(game, REFUSED_UNEVEN_SALE);
+        return;
     }
     
-    property->houses--;
+    setHouses(game, propertyIndex, state->houses - 1);
     currentPlayer->money += property->houseCost / 2;
+    journalEvent(game, JOURNAL_BUILD, game->currentPlayer, propertyIndex, state->houses, property->houseCost / 2);
+    emitEvent(game, EVENT_SELL_HOUSE, game->currentPlayer, propertyIndex, property->houseCost / 2, state->houses);
+}
+// Same checks as buildHouse, without any output
+bool canBuildHouse(const GameState* game, const Property board[], int propertyIndex) {
+    const Player* currentPlayer = &game->players[game->currentPlayer];
+    const Property* property = &board[propertyIndex];
+    const SquareState* state = &game->squares[propertyIndex];
+    
+    if (property->type != 1 || state->houses >= HOTEL ||
+        currentPlayer->money < property->houseCost ||
+        !hasMonopoly(game, board, game->currentPlayer, propertyIndex)) {
+        return false;
+    }
     
-    if (property->houses == 4) {
-        cout << "Sold hotel back to houses on " << property->name << endl;
-    } else {
-        cout << "Sold house on " << property->name << endl;
+    SquareMask group = game->board->colorMasks[property->color];
+    if ((game->mortgagedMask & group) != 0) {
+        return false;
     }
-    cout << "Received $" << (property->houseCost / 2) << endl;
+    return state->houses == 0 || (game->houseMasks[state->houses - 1] & group) == group;
 }
 // Special Space Handling Functions
 
-void handleSpecialSpace(GameState* game, Property board[], int position) {
+void handleSpecialSpace(GameState* game, const Property board[], int position) {
     Player* currentPlayer = &game->players[game->currentPlayer];
     
     switch (board[position].type) {
-        case 3: // TAX
-            if (position == 4) { // Income Tax
-                currentPlayer->money -= 200;
-                cout << currentPlayer->name << " paid $200 in Income Tax\n";
-            } else if (position == 38) { // Luxury Tax
-                currentPlayer->money -= 100;
-                cout << currentPlayer->name << " paid $100 in Luxury Tax\n";
-            }
+        case 6: // TAX
+            // The tax is the square's price
+            currentPlayer->money -= board[position].price;
+            journalEvent(game, JOURNAL_PAYMENT, game->currentPlayer, 0, 0, -board[position].price);
+            emitEvent(game, EVENT_TAX, game->currentPlayer, position, board[position].price);
             break;
             
         case 4: // CHANCE
-            handleChance(game, board);
+            drawCard(game, board, CHANCE_DECK);
             break;
             
         case 5: // COMMUNITY_CHEST
-            handleCommunityChest(game, board);
+            drawCard(game, board, COMMUNITY_DECK);
             break;
             
         case 0: // SPECIAL
-            if (position == 30) { // Go to Jail
+            if (position == game->board->goToJailSquare) {
                 goToJail(game);
             }
             break;
     }
 }
 
-void handleChance(GameState* game, Property board[]) {
+// Draws the next card from a deck and carries it out. A card that moves
+// the player leaves the new square to be resolved by the turn (see turn.cpp).
+void drawCard(GameState* game, const Property board[], int deck) {
     Player* currentPlayer = &game->players[game->currentPlayer];
-    Card currentCard = game->chanceCards[game->chanceIndex];
-    
-    cout << "\nChance Card: " << currentCard.text << endl;
-    
-    switch (currentCard.actionType) {
-        case 0: // Move
-            if (currentCard.actionValue < currentPlayer->position) {
-                currentPlayer->money += 200;
-                cout << "Passed GO! Collect $200\n";
+    int slot = game->deckIndex[deck];
+    int cardNumber = game->deckOrder[deck][slot];
+    const Card& card = game->board->cards[deck][cardNumber];
+    
+    emitEvent(game, EVENT_CARD, game->currentPlayer, 0, cardNumber, deck);
+    
+    switch (card.actionType) {
+        case CARD_MOVE_TO:
+        case CARD_MOVE_BY:
+        case CARD_NEAREST_RAILROAD:
+        case CARD_NEAREST_UTILITY: {
+            int destination = cardDestination(game->board, card, currentPlayer->position);
+            int salary = 0;
+            if (card.actionType != CARD_MOVE_BY && destination < currentPlayer->position) {
+                salary = game->board->goSalary;
+                currentPlayer->money += salary;
+                emitEvent(game, EVENT_PASS_GO, game->currentPlayer);
             }
-            currentPlayer->position = currentCard.actionValue;
-            cout << "Moved to " << board[currentPlayer->position].name << endl;
-            break;
-            
-        case 1: // Money change
-            currentPlayer->money += currentCard.actionValue;
-            if (currentCard.actionValue > 0) {
-                cout << "Collected $" << currentCard.actionValue << endl;
-            } else {
-                cout << "Paid $" << -currentCard.actionValue << endl;
+            currentPlayer->position = destination;
+            if (card.actionType == CARD_NEAREST_RAILROAD || card.actionType == CARD_NEAREST_UTILITY) {
+                game->turn.cardRent = card.actionType;
             }
+            journalEvent(game, JOURNAL_MOVE, game->currentPlayer, destination, 0, salary);
+            emitEvent(game, EVENT_CARD_MOVE, game->currentPlayer, destination);
             break;
+        }
             
-        case 2: // Get out of jail free
-            currentPlayer->getOutOfJailCards++;
-            cout << "Received Get Out of Jail Free card\n";
+        case CARD_MONEY:
+            currentPlayer->money += card.actionValue;
+            journalEvent(game, JOURNAL_PAYMENT, game->currentPlayer, 0, 0, card.actionValue);
+            emitEvent(game, EVENT_CARD_MONEY, game->currentPlayer, 0, card.actionValue);
             break;
-    }
-    
-    game->chanceIndex = (game->chanceIndex + 1) % 16;
-}
-
-void handleCommunityChest(GameState* game, Property board[]) {
-    Player* currentPlayer = &game->players[game->currentPlayer];
-    Card currentCard = game->communityCards[game->communityIndex];
-    
-    cout << "\nCommunity Chest Card: " << currentCard.text << endl;
-    
-    switch (currentCard.actionType) {
-        case 0: // Move
-            if (currentCard.actionValue < currentPlayer->position) {
-                currentPlayer->money += 200;
-                cout << "Passed GO! Collect $200\n";
+            
+        case CARD_REPAIRS: {
+            SquareMask owned = game->ownedMasks[game->currentPlayer];
+            int hotels = countSquares(owned & game->houseMasks[HOTEL - 1]);
+            int houses = -MAX_HOUSES * hotels;
+            for (int k = 0; k < MAX_HOUSES; k++) {
+                houses += countSquares(owned & game->houseMasks[k]);
             }
-            currentPlayer->position = currentCard.actionValue;
-            cout << "Moved to " << board[currentPlayer->position].name << endl;
+            int amount = houses * card.actionValue + hotels * card.hotelValue;
+            currentPlayer->money += amount;
+            journalEvent(game, JOURNAL_PAYMENT, game->currentPlayer, 0, 0, amount);
+            emitEvent(game, EVENT_CARD_MONEY, game->currentPlayer, 0, amount);
             break;
+        }
             
-        case 1: // Money change
-            currentPlayer->money += currentCard.actionValue;
-            if (currentCard.actionValue > 0) {
-                cout << "Collected $" << currentCard.actionValue << endl;
-            } else {
-                cout << "Paid $" << -currentCard.actionValue << endl;
+        case CARD_EACH_PLAYER: {
+            // A player the card leaves in debt settles it now, as if on
+            // their own turn; the drawer's debt is settled when the turn
+            // resolves
+            int drawer = game->currentPlayer;
+            int total = 0;
+            for (int i = 0; i < game->numPlayers; i++) {
+                if (i != drawer && !game->players[i].bankrupt) {
+                    game->players[i].money -= card.actionValue;
+                    journalEvent(game, JOURNAL_PAYMENT, i, 0, 0, -card.actionValue);
+                    total += card.actionValue;
+                    if (card.actionValue > 0 && game->players[i].money < 0) {
+                        game->currentPlayer = i;
+                        handleBankruptcy(game, board);
+                        game->currentPlayer = drawer;
+                    }
+                }
             }
+            currentPlayer->money += total;
+            journalEvent(game, JOURNAL_PAYMENT, drawer, 0, 0, total);
+            emitEvent(game, EVENT_CARD_MONEY, drawer, 0, total);
             break;
+        }
             
-        case 2: // Get out of jail free
+        case CARD_JAIL_FREE:
             currentPlayer->getOutOfJailCards++;
-            cout << "Received Get Out of Jail Free card\n";
+            journalJail(game, game->currentPlayer);
+            emitEvent(game, EVENT_JAIL_CARD_RECEIVED, game->currentPlayer);
+            break;
+            
+        case CARD_GO_TO_JAIL:
+            goToJail(game);
             break;
     }
     
-    game->communityIndex = (game->communityIndex + 1) % 16;
+    journalEvent(game, JOURNAL_CARD, game->currentPlayer, deck, slot, 0);
+    game->deckIndex[deck] = (slot + 1) % DECK_SIZE;
 }
 
 void goToJail(GameState* game) {
     Player* currentPlayer = &game->players[game->currentPlayer];
-    currentPlayer->position = 10; // Jail position
+    currentPlayer->position = game->board->jailSquare;
     currentPlayer->inJail = true;
     currentPlayer->jailTurns = 0;
-    cout << currentPlayer->name << " was sent to Jail!\n";
+    journalEvent(game, JOURNAL_MOVE, game->currentPlayer, game->board->jailSquare, 0, 0);
+    journalJail(game, game->currentPlayer);
+    emitEvent(game, EVENT_SENT_TO_JAIL, game->currentPlayer);
 }
 
-void handleJailTurn(GameState* game, Property board[]) {
+// Carries out a jailed player's choice (1=pay, 2=card, 3=roll). Returns
+// the roll to move by if the player got out, or 0 if they stay in jail.
+int handleJailTurn(GameState* game, const Property board[], int choice) {
     Player* currentPlayer = &game->players[game->currentPlayer];
-    
-    cout << "\nYou are in Jail! Turn " << (currentPlayer->jailTurns + 1) << " of 3\n"
-         << "1. Pay $50 fine\n"
-         << "2. Use Get Out of Jail Free card\n"
-         << "3. Roll for doubles\n"
-         << "Choice: ";
-         
-    int choice;
-    cin >> choice;
+    int turnsInJail = currentPlayer->jailTurns + 1; // counting this one
     
     switch (choice) {
         case 1:
-            if (currentPlayer->money >= 50) {
-                currentPlayer->money -= 50;
+            if (currentPlayer->money >= game->board->jailFine) {
+                currentPlayer->money -= game->board->jailFine;
                 currentPlayer->inJail = false;
                 currentPlayer->jailTurns = 0;
-                cout << "Paid fine. You're out of jail!\n";
+                journalEvent(game, JOURNAL_PAYMENT, game->currentPlayer, 0, 0, -game->board->jailFine);
+                journalJail(game, game->currentPlayer);
+                emitEvent(game, EVENT_LEFT_JAIL, game->currentPlayer, 0, turnsInJail, JAIL_EXIT_FINE);
                 
                 // Regular turn
                 int dice1, dice2;
-                rollDice(&dice1, &dice2);
-                cout << "Rolled: " << dice1 << " and " << dice2 << endl;
-                movePlayer(game, board, dice1 + dice2);
-                handleProperty(game, board, dice1 + dice2);
+                rollDice(game, &dice1, &dice2);
+                emitEvent(game, EVENT_ROLL, game->currentPlayer, 0, dice1, dice2);
+                return dice1 + dice2;
             } else {
-                cout << "Not enough money to pay fine!\n";
+                emitRefusal(game, REFUSED_CANNOT_AFFORD_FINE);
             }
             break;
             
@@ -864,121 +820,126 @@ void handleJailTurn(GameState* game, Property board[]) {
                 currentPlayer->getOutOfJailCards--;
                 currentPlayer->inJail = false;
                 currentPlayer->jailTurns = 0;
-                cout << "Used Get Out of Jail Free card!\n";
+                journalJail(game, game->currentPlayer);
+                emitEvent(game, EVENT_LEFT_JAIL, game->currentPlayer, 0, turnsInJail, JAIL_EXIT_CARD);
                 
                 // Regular turn
                 int dice1, dice2;
-                rollDice(&dice1, &dice2);
-                cout << "Rolled: " << dice1 << " and " << dice2 << endl;
-                movePlayer(game, board, dice1 + dice2);
-                handleProperty(game, board, dice1 + dice2);
+                rollDice(game, &dice1, &dice2);
+                emitEvent(game, EVENT_ROLL, game->currentPlayer, 0, dice1, dice2);
+                return dice1 + dice2;
             } else {
-                cout << "No Get Out of Jail Free cards!\n";
+                emitRefusal(game, REFUSED_NO_JAIL_CARD);
             }
             break;
             
         case 3:
             int dice1, dice2;
-            rollDice(&dice1, &dice2);
-            cout << "Rolled: " << dice1 << " and " << dice2 << endl;
+            rollDice(game, &dice1, &dice2);
+            emitEvent(game, EVENT_ROLL, game->currentPlayer, 0, dice1, dice2);
             
             if (isDouble(dice1, dice2)) {
                 currentPlayer->inJail = false;
                 currentPlayer->jailTurns = 0;
-                cout << "Rolled doubles! You're out of jail!\n";
-                movePlayer(game, board, dice1 + dice2);
-                handleProperty(game, board, dice1 + dice2);
+                journalJail(game, game->currentPlayer);
+                emitEvent(game, EVENT_LEFT_JAIL, game->currentPlayer, 0, turnsInJail, JAIL_EXIT_DOUBLES);
+                return dice1 + dice2;
             } else {
                 currentPlayer->jailTurns++;
+                journalJail(game, game->currentPlayer);
                 if (currentPlayer->jailTurns >= 3) {
-                    currentPlayer->money -= 50;
+                    currentPlayer->money -= game->board->jailFine;
                     currentPlayer->inJail = false;
                     currentPlayer->jailTurns = 0;
-                    cout << "Third turn in jail. Paid $50 fine.\n";
-                    movePlayer(game, board, dice1 + dice2);
-                    handleProperty(game, board, dice1 + dice2);
+                    journalEvent(game, JOURNAL_PAYMENT, game->currentPlayer, 0, 0, -game->board->jailFine);
+                    journalJail(game, game->currentPlayer);
+                    emitEvent(game, EVENT_LEFT_JAIL, game->currentPlayer, 0, turnsInJail, JAIL_EXIT_THIRD_TURN);
+                    return dice1 + dice2;
                 }
             }
             break;
     }
+    return 0;
 }
 
-void handleBankruptcy(GameState* game, Property board[]) {
+void handleBankruptcy(GameState* game, const Property board[]) {
+    PROFILE_SCOPE(PROFILE_HANDLE_BANKRUPTCY);
     Player* currentPlayer = &game->players[game->currentPlayer];
     
-    // First try to mortgage all properties
-    for (int i = 0; i < currentPlayer->propertyCount; i++) {
-        if (currentPlayer->ownedProperties[i] != -1) {
-            Property* prop = &board[currentPlayer->ownedProperties[i]];
-            if (!prop->mortgaged) {
-                mortgageProperty(game, board, currentPlayer->ownedProperties[i]);
-            }
-        }
-    }
-    
-    // If still in debt, sell all houses
-    if (currentPlayer->money < 0) {
-        for (int i = 0; i < currentPlayer->propertyCount; i++) {
-            if (currentPlayer->ownedProperties[i] != -1) {
-                while (board[currentPlayer->ownedProperties[i]].houses > 0) {
-                    sellHouse(game, board, currentPlayer->ownedProperties[i]);
-                }
-            }
-        }
+    // Raise the debt the cheapest way there is (see liquidation.h). If
+    // everything together wouldn't cover it, nothing is sold.
+    LiquidationPlan plan;
+    if (planLiquidation(game, board, -currentPlayer->money, &plan)) {
+        executeLiquidation(game, board, &plan);
     }
     
     // If still in debt, declare bankruptcy
     if (currentPlayer->money < 0) {
-        cout << currentPlayer->name << " has gone bankrupt!\n";
-        currentPlayer->bankrupt = true;
-        
-        // Return all properties to bank
-        for (int i = 0; i < currentPlayer->propertyCount; i++) {
-            if (currentPlayer->ownedProperties[i] != -1) {
-                Property* prop = &board[currentPlayer->ownedProperties[i]];
-                prop->owner = -1;
-                prop->houses = 0;
-                prop->mortgaged = false;
-            }
-        }
-        currentPlayer->propertyCount = 0;
+        emitEvent(game, EVENT_BANKRUPT, game->currentPlayer);
+        returnPropertiesToBank(game, board, game->currentPlayer);
+    }
+}
+
+// Marks a player bankrupt and gives everything they own back to the bank
+void returnPropertiesToBank(GameState* game, const Property board[], int playerNum) {
+    Player* player = &game->players[playerNum];
+    player->bankrupt = true;
+    journalEvent(game, JOURNAL_BANKRUPT, playerNum, 0, 0, 0);
+    
+    // From the back, so each removal is a plain pop
+    while (player->propertyCount > 0) {
+        int propertyIndex = player->ownedProperties[player->propertyCount - 1];
+        setPropertyOwner(game, board, propertyIndex, -1);
+        setHouses(game, propertyIndex, 0);
+        setMortgaged(game, propertyIndex, false);
     }
 }
 
 // Save/Load Functions
 void saveGame(const GameState* game, const Property board[]) {
+    PROFILE_SCOPE(PROFILE_SAVE_GAME);
+    unsigned char buffer[MAX_SAVE_SIZE];
+    int length = encodeGame(game, buffer, MAX_SAVE_SIZE);
+    if (length == 0) {
+        cout << "Error encoding save file!\n";
+        return;
+    }
+    
     ofstream outFile("monopoly_save.dat", ios::binary);
     if (!outFile) {
         cout << "Error opening save file!\n";
         return;
     }
     
-    outFile.write(reinterpret_cast<const char*>(game), sizeof(GameState));
-    outFile.write(reinterpret_cast<const char*>(board), sizeof(Property) * BOARD_SIZE);
-    
+    outFile.write(reinterpret_cast<const char*>(buffer), length);
     outFile.close();
     cout << "Game saved successfully!\n";
 }
 
-bool loadGame(GameState* game, Property board[]) {
+bool loadGame(GameState* game, PlayerNames* names) {
     ifstream inFile("monopoly_save.dat", ios::binary);
     if (!inFile) {
         cout << "No saved game found.\n";
         return false;
     }
     
-    try {
-        inFile.read(reinterpret_cast<char*>(game), sizeof(GameState));
-        inFile.read(reinterpret_cast<char*>(board), sizeof(Property) * BOARD_SIZE);
-        
-        inFile.close();
-        cout << "Game loaded successfully!\n";
-        return true;
-    } catch (...) {
-        inFile.close();
-        cout << "Error loading game file.\n";
+    // Saves are small: read the whole file at once and decode from memory.
+    // One byte past the limit is read so an oversized file fails the length check.
+    unsigned char buffer[MAX_SAVE_SIZE + 1];
+    inFile.read(reinterpret_cast<char*>(buffer), sizeof(buffer));
+    int length = static_cast<int>(inFile.gcount());
+    inFile.close();
+    
+    int result = decodeGame(buffer, length, game, names);
+    if (result != SAVE_OK) {
+        cout << "The save file " << saveErrorMessage(result) << ".\n";
         return false;
     }
+    
+    assignConsoleControllers(game);
+    
+    cout << "Game loaded successfully!\n";
+    return true;
 }
 
 bool checkWinCondition(const GameState* game) {
@@ -993,129 +954,101 @@ bool checkWinCondition(const GameState* game) {
     }
     
     if (activePlayers == 1) {
-        cout << "\nGame Over! " << game->players[lastActivePlayer].name << " wins!\n";
+        emitEvent(game, EVENT_GAME_OVER, lastActivePlayer);
         return true;
     }
     return false;
 }
-void processPlayerTurn(GameState* game, Property board[]) {
+// Drives the current player's turn from the console. Buy and jail
+// questions go to the player's controller; everything else is the menu.
+void processPlayerTurn(GameState* game, const Property board[]) {
+    PROFILE_SCOPE(PROFILE_PROCESS_PLAYER_TURN);
+    int decision = runTurn(game, board);
+    if (decision == DECISION_NONE) {
+        return; // bankrupt players are skipped
+    }
     Player* currentPlayer = &game->players[game->currentPlayer];
     
-    if (currentPlayer->bankrupt) {
-        game->currentPlayer = (game->currentPlayer + 1) % game->numPlayers;
+    if (currentPlayer->computer) {
+        cout << "\n=== " << playerName(game, game->currentPlayer) << "'s turn (computer) ===\n";
+        playTurn(game, board);
         return;
     }
 
-    cout << "\n=== " << currentPlayer->name << "'s turn ===\n";
-    cout << "Current money: $" << currentPlayer->money << endl;
-    cout << "Current position: " << board[currentPlayer->position].name << endl;
+    cout << "\n=== " << playerName(game, game->currentPlayer) << "'s turn ===\n";
+    cout << "Current money: $" << currentPlayer->money << '\n';
+    cout << "Current position: " << board[currentPlayer->position].name << '\n';
     
     int choice = 0;
-    bool turnEnded = false;
-    bool hasRolled = false;
     
-    while (!turnEnded) {
+    while (decision != DECISION_NONE) {
+        if (decision != DECISION_ROLL) {
+            decision = resumeTurn(game, board, controllerAnswer(game, board, decision));
+            if (decision == DECISION_ROLL) {
+                cout << "Doubles! You get another roll!\n";
+            }
+            continue;
+        }
+        
         displayMenu();
         cin >> choice;
         
         switch (choice) {
-            case 1: { // Roll Dice
-                if (hasRolled) {
-                    cout << "You've already rolled this turn!\n";
-                    break;
-                }
-                
-                if (currentPlayer->inJail) {
-                    handleJailTurn(game, board);
-                    turnEnded = true;
-                } else {
-                    int dice1, dice2;
-                    rollDice(&dice1, &dice2);
-                    cout << "\nRolled: " << dice1 << " and " << dice2 << endl;
-                    
-                    movePlayer(game, board, dice1 + dice2);
-                    handleProperty(game, board, dice1 + dice2);
-                    handleSpecialSpace(game, board, currentPlayer->position);
-                    
-                    hasRolled = true;
-                    if (!isDouble(dice1, dice2)) {
-                        turnEnded = true;
-                    } else {
-                        cout << "Doubles! You get another roll!\n";
-                        hasRolled = false;
-                    }
+            case 1: // Roll Dice
+                decision = resumeTurn(game, board, 0);
+                if (decision == DECISION_ROLL) {
+                    cout << "Doubles! You get another roll!\n";
                 }
                 break;
-            }
             
             case 2: // View Properties
                 displayPlayerProperties(game, board, game->currentPlayer);
                 break;
                 
             case 3: // Trade
-                if (!hasRolled) {
-                    tradeProperties(game, board);
-                } else {
-                    cout << "Cannot trade after rolling dice!\n";
-                }
+                tradeProperties(game, board);
                 break;
                 
             case 4: { // Build Houses
-                if (!hasRolled) {
-                    displayPlayerProperties(game, board, game->currentPlayer);
-                    cout << "Enter property number to build house on (0 to cancel): ";
-                    int propNum;
-                    cin >> propNum;
-                    if (propNum > 0) {
-                        buildHouse(game, board, currentPlayer->ownedProperties[propNum - 1]);
-                    }
-                } else {
-                    cout << "Cannot build houses after rolling dice!\n";
+                displayPlayerProperties(game, board, game->currentPlayer);
+                cout << "Enter property number to build house on (0 to cancel): ";
+                int propNum;
+                cin >> propNum;
+                if (propNum > 0 && propNum <= currentPlayer->propertyCount) {
+                    buildHouse(game, board, currentPlayer->ownedProperties[propNum - 1]);
                 }
                 break;
             }
             
             case 5: { // Sell Houses
-                if (!hasRolled) {
-                    displayPlayerProperties(game, board, game->currentPlayer);
-                    cout << "Enter property number to sell house from (0 to cancel): ";
-                    int propNum;
-                    cin >> propNum;
-                    if (propNum > 0) {
-                        sellHouse(game, board, currentPlayer->ownedProperties[propNum - 1]);
-                    }
-                } else {
-                    cout << "Cannot sell houses after rolling dice!\n";
+                displayPlayerProperties(game, board, game->currentPlayer);
+                cout << "Enter property number to sell house from (0 to cancel): ";
+                int propNum;
+                cin >> propNum;
+                if (propNum > 0 && propNum <= currentPlayer->propertyCount) {
+                    sellHouse(game, board, currentPlayer->ownedProperties[propNum - 1]);
                 }
                 break;
             }
             
             case 6: { // Mortgage Property
-                if (!hasRolled) {
-                    displayPlayerProperties(game, board, game->currentPlayer);
-                    cout << "Enter property number to mortgage (0 to cancel): ";
-                    int propNum;
-                    cin >> propNum;
-                    if (propNum > 0) {
-                        mortgageProperty(game, board, currentPlayer->ownedProperties[propNum - 1]);
-                    }
-                } else {
-                    cout << "Cannot mortgage properties after rolling dice!\n";
+                displayPlayerProperties(game, board, game->currentPlayer);
+                cout << "Enter property number to mortgage (0 to cancel): ";
+                int propNum;
+                cin >> propNum;
+                if (propNum > 0 && propNum <= currentPlayer->propertyCount) {
+                    mortgageProperty(game, board, currentPlayer->ownedProperties[propNum - 1]);
                 }
                 break;
             }
             
             case 7: { // Unmortgage Property
-                if (!hasRolled) {
-                    displayPlayerProperties(game, board, game->currentPlayer);
-                    cout << "Enter property number to unmortgage (0 to cancel): ";
-                    int propNum;
-                    cin >> propNum;
-                    if (propNum > 0) {
-                        unmortgageProperty(game, board, currentPlayer->ownedProperties[propNum - 1]);
-                    }
-                } else {
-                    cout << "Cannot unmortgage properties after rolling dice!\n";
+                displayPlayerProperties(game, board, game->currentPlayer);
+                cout << "Enter property number to unmortgage (0 to cancel): ";
+                int propNum;
+                cin >> propNum;
+                if (propNum > 0 && propNum <= currentPlayer->propertyCount) {
+                    unmortgageProperty(game, board, currentPlayer->ownedProperties[propNum - 1]);
                 }
                 break;
             }
@@ -1126,21 +1059,63 @@ void processPlayerTurn(GameState* game, Property board[]) {
                 
             case 9: // Quit
                 game->gameOver = true;
-                turnEnded = true;
+                finishTurn(game);
+                decision = DECISION_NONE;
                 break;
                 
             default:
                 cout << "Invalid choice. Please try again.\n";
                 break;
         }
-        
-        if (currentPlayer->money < 0) {
-            cout << "\nWARNING: You are in debt! Amount: $" << currentPlayer->money << endl;
-            handleBankruptcy(game, board);
-            turnEnded = true;
-        }
     }
+}
+
+// Console Player Functions
+static bool consoleWantsToBuy(const GameState* game, const Property board[], int propertyIndex, void* context) {
+    char choice;
+    cout << "Would you like to buy " << board[propertyIndex].name 
+         << " for $" << board[propertyIndex].price << "? (y/n): ";
+    cin >> choice;
+    return choice == 'y' || choice == 'Y';
+}
+
+static int consoleChooseJailOption(const GameState* game, const Property board[], void* context) {
+    const Player* currentPlayer = &game->players[game->currentPlayer];
     
-    game->currentPlayer = (game->currentPlayer + 1) % game->numPlayers;
+    cout << "\nYou are in Jail! Turn " << (currentPlayer->jailTurns + 1) << " of 3\n"
+         << "1. Pay $" << game->board->jailFine << " fine\n"
+         << "2. Use Get Out of Jail Free card\n"
+         << "3. Roll for doubles\n"
+         << "Choice: ";
+         
+    int choice;
+    cin >> choice;
+    return choice;
+}
+
+// The menu in processPlayerTurn asks for build/mortgage targets itself
+static int consoleNoChoice(const GameState* game, const Property board[], void* context) {
+    return -1;
+}
+
+static bool consoleProposeTrade(const GameState* game, const Property board[], TradeOffer* offer, void* context) {
+    return false;
+}
+
+static bool consoleAcceptTrade(const GameState* game, const Property board[], const TradeOffer* offer, void* context) {
+    cout << "\n" << playerName(game, offer->toPlayer) << ", do you accept this trade? (y/n): ";
+    char choice;
+    cin >> choice;
+    return choice == 'y' || choice == 'Y';
 }
 
+PlayerController CONSOLE_PLAYER = {
+    consoleWantsToBuy,
+    consoleChooseJailOption,
+    consoleNoChoice,
+    consoleNoChoice,
+    consoleNoChoice,
+    consoleProposeTrade,
+    consoleAcceptTrade,
+    0
+};
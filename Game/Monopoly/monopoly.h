@@ -8,25 +8,66 @@
 #include <fstream>
 #include <iomanip>
 #include <cstring>
+#include "dice.h"
 
 using namespace std;
 
 // Constants
 const int MAX_PLAYERS = 4;
-const int BOARD_SIZE = 40;
+const int MAX_BOARD_SIZE = 64; // one bit per square in a SquareMask
 const int MAX_NAME_LENGTH = 50;
 const int STARTING_MONEY = 1500;
+const int GO_SALARY = 200;
 const int MAX_HOUSES = 4;
 const int HOTEL = 5;
 const int NUM_RAILROADS = 4;
 const int NUM_UTILITIES = 2;
 const int GET_OUT_OF_JAIL_COST = 50;
-const int JAIL_POSITION = 10;
+const int NUM_COLORS = 8;
+const int DECK_SIZE = 16;
+
+// A set of board squares, bit i for square i
+typedef unsigned long long SquareMask;
+
+constexpr SquareMask squareBit(int square) {
+    return 1ULL << square;
+}
+
+inline int countSquares(SquareMask mask) {
+    return __builtin_popcountll(mask);
+}
+
+// Output levels for game events (see events.h)
+const int OUTPUT_SILENT = 0;  // nothing: headless and tournament games
+const int OUTPUT_SUMMARY = 1; // money changing hands, bankruptcies, the winner
+const int OUTPUT_VERBOSE = 2; // also every roll, move, card and refused action
+const int CHANCE_DECK = 0;
+const int COMMUNITY_DECK = 1;
+const int NUM_DECKS = 2;
+
+// Card effects (Card::actionType)
+const int CARD_MOVE_TO = 0;          // actionValue = square; salary for passing GO
+const int CARD_MONEY = 1;            // actionValue = money received (negative when paying)
+const int CARD_JAIL_FREE = 2;
+const int CARD_MOVE_BY = 3;          // actionValue = squares forward (negative goes back)
+const int CARD_GO_TO_JAIL = 4;
+const int CARD_NEAREST_RAILROAD = 5; // owner gets twice the rent
+const int CARD_NEAREST_UTILITY = 6;  // owner gets ten times the roll
+const int CARD_REPAIRS = 7;          // actionValue per house, hotelValue per hotel
+const int CARD_EACH_PLAYER = 8;      // actionValue from each other player (negative pays each)
+
+// Decisions a suspended turn waits on (see turn.h)
+const int DECISION_NONE = 0; // the turn is over
+const int DECISION_ROLL = 1; // roll; trading, building and mortgages happen before this
+const int DECISION_BUY = 2;  // buy turn.square? answer 1=yes, 0=no
+const int DECISION_JAIL = 3; // answer 1=pay, 2=card, 3=roll
 
 // Structure Definitions
+
+// Immutable square data, shared by every game on the same board
 struct Property {
     char name[MAX_NAME_LENGTH];
-    int type;  // 0=SPECIAL, 1=REGULAR_PROPERTY, 2=RAILROAD, 3=TAX, 4=CHANCE, 5=COMMUNITY_CHEST
+    int type;  // 0=SPECIAL, 1=REGULAR_PROPERTY, 2=RAILROAD, 3=UTILITY, 4=CHANCE, 5=COMMUNITY_CHEST, 6=TAX
     int color; // -1=NONE, 0=BROWN, 1=LIGHT_BLUE, etc.
     int price;
     int baseRent;
@@ -34,74 +75,192 @@ struct Property {
     int rentWithHouses[4];
     int rentWithHotel;
     int houseCost;
-    int owner;  // -1 for unowned
-    int houses; // 0-4 for houses, 5 for hotel
+    int mortgageValue;
+    int unmortgageCost;
+};
+
+struct Card {
+    const char* text;
+    int actionType; // CARD_*
+    int actionValue;
+    int hotelValue;
+};
+
+// A board definition plus the square sets derived from it. The standard
+// board is built by the compiler (see board.h), others by loadBoard.
+struct Board {
+    int size;
+    int jailSquare;
+    int goToJailSquare;
+    unsigned int id; // hash of the definition, so saves can tell boards apart
+    
+    // Money rules: the constants above unless a sweep varies them (see sweep.h)
+    int startingMoney;
+    int goSalary;
+    int jailFine;
+    
+    Property squares[MAX_BOARD_SIZE];
+    Card cards[NUM_DECKS][DECK_SIZE]; // advance-to cards hold this board's squares
+    SquareMask colorMasks[NUM_COLORS];
+    SquareMask railroadMask;
+    SquareMask utilityMask;
+};
+
+// Mutable per-game state of one square
+struct SquareState {
+    signed char owner;    // -1 for unowned
+    unsigned char houses; // 0-4 for houses, 5 for hotel
     bool mortgaged;
+    unsigned char slot;   // index in the owner's ownedProperties, 0 if unowned
 };
 
 struct Player {
-    char name[MAX_NAME_LENGTH];
     int money;
-    int position;
+    unsigned char position;
+    unsigned char jailTurns;
+    unsigned char getOutOfJailCards;
+    unsigned char propertyCount;
     bool inJail;
-    int jailTurns;
     bool bankrupt;
-    int getOutOfJailCards;
-    int ownedProperties[BOARD_SIZE];
-    int propertyCount;
+    bool computer; // console games: played by MCTS_BOT (see mcts.h)
+    signed char ownedProperties[MAX_BOARD_SIZE]; // dense; -1 past propertyCount
 };
 
-struct Card {
-    char text[MAX_NAME_LENGTH];
-    int actionType;
-    int actionValue;
+// Player names are only read for display, so they live outside GameState
+struct PlayerNames {
+    char name[MAX_PLAYERS][MAX_NAME_LENGTH];
+};
+
+struct GameState;
+
+// A trade between two players. Property fields are indices into the
+// owners' ownedProperties lists (-1 for none).
+struct TradeOffer {
+    int fromPlayer;
+    int toPlayer;
+    int offeredProperty;
+    int requestedProperty;
+    int offeredMoney;
+    int requestedMoney;
+};
+
+// Player decision callbacks. Every choice the rules ask a player to make
+// goes through one of these, so the same engine code runs for console
+// players (prompting on cin) and for headless bots (no I/O at all).
+struct PlayerController {
+    bool (*wantsToBuy)(const GameState* game, const Property board[], int propertyIndex, void* context);
+    int (*chooseJailOption)(const GameState* game, const Property board[], void* context); // 1=pay, 2=card, 3=roll
+    int (*chooseBuild)(const GameState* game, const Property board[], void* context);       // board index or -1
+    int (*chooseMortgage)(const GameState* game, const Property board[], void* context);    // board index or -1
+    int (*chooseUnmortgage)(const GameState* game, const Property board[], void* context);  // board index or -1
+    bool (*proposeTrade)(const GameState* game, const Property board[], TradeOffer* offer, void* context);
+    bool (*acceptTrade)(const GameState* game, const Property board[], const TradeOffer* offer, void* context);
+    void* context;
+};
+
+// How far the current player's turn has got. A turn only stops at a
+// decision, so this and the rest of GameState are all it needs to resume.
+struct TurnState {
+    unsigned char phase;
+    unsigned char decision; // DECISION_*
+    unsigned char square;   // square on offer for DECISION_BUY
+    unsigned char rolls;    // rolls made so far this turn
+    unsigned char dice1;
+    unsigned char dice2;
+    bool fromJail;          // the last roll took the player out of jail
+    unsigned char cardRent; // CARD_NEAREST_* while landing from that card, else 0
 };
 
+struct Journal;
+struct UndoLog;
+struct Replay;
+struct Stats;
+
+// Everything that changes during a game, packed together. Board data,
+// card texts and player names are shared through pointers.
 struct GameState {
     Player players[MAX_PLAYERS];
+    SquareState squares[MAX_BOARD_SIZE];
+    
+    // Ownership index, kept in step with SquareState by setPropertyOwner,
+    // setHouses and setMortgaged, and rebuilt by rebuildOwnershipIndex
+    SquareMask ownedMasks[MAX_PLAYERS];
+    SquareMask mortgagedMask;
+    SquareMask houseMasks[HOTEL]; // houseMasks[k]: squares with more than k houses
+    
     int numPlayers;
     int currentPlayer;
+    unsigned char deckOrder[NUM_DECKS][DECK_SIZE]; // card numbers in draw order
+    int deckIndex[NUM_DECKS];                      // next slot to draw
     bool gameOver;
-    Card chanceCards[16];
-    Card communityCards[16];
-    int chanceIndex;
-    int communityIndex;
-    Property* board;
+    int outputLevel; // OUTPUT_*
+    Dice dice;
+    TurnState turn;
+    
+    const Board* board;
+    const PlayerNames* names;
+    PlayerController* controllers[MAX_PLAYERS];
+    Journal* journal; // null unless the game is being journaled
+    UndoLog* undo;    // null unless changes are being recorded for undo (see undo.h)
+    Replay* replay;   // null unless decisions are being recorded (see replay.h)
+    Stats* stats;     // null unless statistics are being collected (see stats.h)
 };
 
+inline const char* playerName(const GameState* game, int playerNum) {
+    return game->names->name[playerNum];
+}
+
 // Function declarations
-void initializeBoard(Property[]);
+void initializeBoard(GameState*, const Board*);
 void initializeCards(GameState*);
-void initializePlayers(GameState*);
-void rollDice(int*, int*);
+void initializePlayers(GameState*, PlayerNames*);
+void initializePlayer(Player*, int);
+void assignConsoleControllers(GameState*);
+void rollDice(GameState*, int*, int*);
 bool isDouble(int, int);
-void movePlayer(GameState*, Property[], int);
-void handleProperty(GameState*, Property[], int);
-void handleSpecialSpace(GameState*, Property[], int);
-void handleChance(GameState*, Property[]);
-void handleCommunityChest(GameState*, Property[]);
+void movePlayer(GameState*, const Property[], int);
+bool handleProperty(GameState*, const Property[], int);
+void buyProperty(GameState*, const Property[], int);
+void handleSpecialSpace(GameState*, const Property[], int);
+void drawCard(GameState*, const Property[], int);
+int cardDestination(const Board*, const Card&, int);
 void displayGameState(const GameState*, const Property[]);
-void displayProperty(const Property&);
+void displayProperty(const Property&, const SquareState&);
 void displayPlayerProperties(const GameState*, const Property[], int);
-void tradeProperties(GameState*, Property[]);
+void tradeProperties(GameState*, const Property[]);
+bool isValidTradeSelection(const GameState*, const TradeOffer*);
+bool isAffordableTrade(const GameState*, const TradeOffer*);
+bool executeTrade(GameState*, const Property[], const TradeOffer*);
 bool hasMonopoly(const GameState*, const Property[], int, int);
-void mortgageProperty(GameState*, Property[], int);
-void unmortgageProperty(GameState*, Property[], int);
-void buildHouse(GameState*, Property[], int);
-void sellHouse(GameState*, Property[], int);
+void mortgageProperty(GameState*, const Property[], int);
+void unmortgageProperty(GameState*, const Property[], int);
+void buildHouse(GameState*, const Property[], int);
+void sellHouse(GameState*, const Property[], int);
 int calculateRent(const Property&, const GameState*, int, int);
 bool canBuildHouse(const GameState*, const Property[], int);
-void handleJailTurn(GameState*, Property[]);
-void handleBankruptcy(GameState*, Property[]);
+int handleJailTurn(GameState*, const Property[], int);
+void handleBankruptcy(GameState*, const Property[]);
+void returnPropertiesToBank(GameState*, const Property[], int);
 void goToJail(GameState*);
 int countRailroadsOwned(const GameState* game, const Property* board, int playerNum);
 int countUtilitiesOwned(const GameState* game, const Property* board, int playerNum);
 bool hasMonopoly(const GameState* game, const Property* board, int playerNum, int propertyIndex);
-void processPlayerTurn(GameState*, Property[]);
+void rebuildOwnershipIndex(GameState*, const Property[]);
+void setPropertyOwner(GameState*, const Property[], int, int);
+void setHouses(GameState*, int, int);
+void setMortgaged(GameState*, int, bool);
+void processPlayerTurn(GameState*, const Property[]);
 bool checkWinCondition(const GameState*);
 void saveGame(const GameState*, const Property[]);
-bool loadGame(GameState*, Property[]);
+bool loadGame(GameState*, PlayerNames*);
 void displayMenu();
 void goToJail(GameState* game);
 
+// Console player: prompts on cin for every decision
+extern PlayerController CONSOLE_PLAYER;
+
+// The board initializeBoard deals new games onto: STANDARD_BOARD unless
+// a board file was loaded at startup
+extern const Board* activeBoard;
+
 #endif
\ No newline at end of file
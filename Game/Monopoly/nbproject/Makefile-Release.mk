@@ -35,7 +35,27 @@ OBJECTDIR=${CND_BUILDDIR}/${CND_CONF}/${CND_PLATFORM}
 
 # Object Files
 OBJECTFILES= \
-	${OBJECTDIR}/monopoly.o
+	${OBJECTDIR}/monopoly.o \
+	${OBJECTDIR}/simulation.o \
+	${OBJECTDIR}/tournament.o \
+	${OBJECTDIR}/dice.o \
+	${OBJECTDIR}/savefile.o \
+	${OBJECTDIR}/journal.o \
+	${OBJECTDIR}/markov.o \
+	${OBJECTDIR}/main.o \
+	${OBJECTDIR}/events.o \
+	${OBJECTDIR}/server.o \
+	${OBJECTDIR}/turn.o \
+	${OBJECTDIR}/mcts.o \
+	${OBJECTDIR}/undo.o \
+	${OBJECTDIR}/replay.o \
+	${OBJECTDIR}/boardfile.o \
+	${OBJECTDIR}/sweep.o \
+	${OBJECTDIR}/stats.o \
+	${OBJECTDIR}/profile.o \
+	${OBJECTDIR}/liquidation.o \
+	${OBJECTDIR}/fork.o \
+	${OBJECTDIR}/whatif.o
 
 
 # C Compiler Flags
@@ -52,7 +72,7 @@ FFLAGS=
 ASFLAGS=
 
 # Link Libraries and Options
-LDLIBSOPTIONS=
+LDLIBSOPTIONS=-pthread
 
 # Build Targets
 .build-conf: ${BUILD_SUBPROJECTS}
@@ -67,6 +87,106 @@ ${OBJECTDIR}/monopoly.o: monopoly.cpp
 	${RM} "$@.d"
 	$(COMPILE.cc) -O2 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/monopoly.o monopoly.cpp
 
+${OBJECTDIR}/simulation.o: simulation.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/simulation.o simulation.cpp
+
+${OBJECTDIR}/tournament.o: tournament.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/tournament.o tournament.cpp
+
+${OBJECTDIR}/dice.o: dice.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/dice.o dice.cpp
+
+${OBJECTDIR}/savefile.o: savefile.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/savefile.o savefile.cpp
+
+${OBJECTDIR}/journal.o: journal.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/journal.o journal.cpp
+
+${OBJECTDIR}/markov.o: markov.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/markov.o markov.cpp
+
+${OBJECTDIR}/main.o: main.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/main.o main.cpp
+
+${OBJECTDIR}/events.o: events.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/events.o events.cpp
+
+${OBJECTDIR}/server.o: server.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/server.o server.cpp
+
+${OBJECTDIR}/turn.o: turn.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/turn.o turn.cpp
+
+${OBJECTDIR}/mcts.o: mcts.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/mcts.o mcts.cpp
+
+${OBJECTDIR}/undo.o: undo.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/undo.o undo.cpp
+
+${OBJECTDIR}/replay.o: replay.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/replay.o replay.cpp
+
+${OBJECTDIR}/boardfile.o: boardfile.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/boardfile.o boardfile.cpp
+
+${OBJECTDIR}/sweep.o: sweep.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/sweep.o sweep.cpp
+
+${OBJECTDIR}/stats.o: stats.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/stats.o stats.cpp
+
+${OBJECTDIR}/profile.o: profile.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/profile.o profile.cpp
+
+${OBJECTDIR}/liquidation.o: liquidation.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/liquidation.o liquidation.cpp
+
+${OBJECTDIR}/fork.o: fork.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/fork.o fork.cpp
+
+${OBJECTDIR}/whatif.o: whatif.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/whatif.o whatif.cpp
+
 # Subprojects
 .build-subprojects:
 
@@ -0,0 +1,89 @@
+#include "profile.h"
+
+#ifdef MONOPOLY_PROFILE
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <mutex>
+
+// Counters of the threads that have finished
+static ProfileCounter totals[NUM_PROFILE_POINTS];
+static mutex totalsLock;
+
+static thread_local ProfileCounters threadCounters;
+static thread_local ProfileScope* currentScope = 0;
+
+static long long profileClock() {
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+ProfileCounters::~ProfileCounters() {
+    lock_guard<mutex> guard(totalsLock);
+    for (int i = 0; i < NUM_PROFILE_POINTS; i++) {
+        totals[i].calls += points[i].calls;
+        totals[i].totalNanoseconds += points[i].totalNanoseconds;
+        totals[i].selfNanoseconds += points[i].selfNanoseconds;
+        mergeHistogram(&totals[i].latency, &points[i].latency);
+    }
+}
+
+ProfileScope::ProfileScope(int point) : point(point), childNanoseconds(0), parent(currentScope) {
+    currentScope = this;
+    start = profileClock();
+}
+
+ProfileScope::~ProfileScope() {
+    long long elapsed = profileClock() - start;
+    currentScope = parent;
+    if (parent) {
+        parent->childNanoseconds += elapsed;
+    }
+    
+    ProfileCounter* counter = &threadCounters.points[point];
+    counter->calls++;
+    counter->totalNanoseconds += elapsed;
+    counter->selfNanoseconds += elapsed - childNanoseconds;
+    addSample(&counter->latency, elapsed < INT_MAX ? static_cast<int>(elapsed) : INT_MAX);
+}
+
+static void displayProfile() {
+    int order[NUM_PROFILE_POINTS];
+    for (int i = 0; i < NUM_PROFILE_POINTS; i++) {
+        order[i] = i;
+    }
+    sort(order, order + NUM_PROFILE_POINTS, [](int a, int b) {
+        return totals[a].selfNanoseconds > totals[b].selfNanoseconds;
+    });
+    
+    cout << "\n=== Profile (by self time) ===\n";
+    cout << left << setw(20) << "Function" << right << setw(12) << "Calls" << setw(12) << "Total ms"
+         << setw(12) << "Self ms" << setw(10) << "Mean ns" << setw(12) << "Median ns" << setw(10) << "99% ns\n";
+    cout << fixed << setprecision(1);
+    for (int i = 0; i < NUM_PROFILE_POINTS; i++) {
+        const ProfileCounter* counter = &totals[order[i]];
+        if (counter->calls == 0) {
+            continue;
+        }
+        cout << left << setw(20) << PROFILE_NAMES[order[i]] << right << setw(12) << counter->calls
+             << setw(12) << counter->totalNanoseconds / 1e6 << setw(12) << counter->selfNanoseconds / 1e6
+             << setw(10) << counter->totalNanoseconds / counter->calls
+             << setw(12) << histogramPercentile(&counter->latency, 0.5)
+             << setw(10) << histogramPercentile(&counter->latency, 0.99) << '\n';
+    }
+    cout.unsetf(ios::fixed);
+    cout << setprecision(6);
+}
+
+// Static objects are destroyed after every thread's counters, including
+// the main thread's, have been added to the totals, so the report is
+// printed from this one's destructor
+struct ProfileReport {
+    ~ProfileReport() {
+        displayProfile();
+    }
+};
+
+static ProfileReport report;
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include "stats.h"
+
+// Hot-path instrumentation. Functions start with PROFILE_SCOPE(point),
+// which counts the call and times it until the function returns. It is
+// compiled in only when MONOPOLY_PROFILE is defined (make profile), and
+// such builds print a flat profile when the program exits. In normal
+// builds PROFILE_SCOPE is empty.
+
+// Instrumented functions
+const int PROFILE_PROCESS_PLAYER_TURN = 0; // console turns, including waiting for input
+const int PROFILE_PLAY_TURN = 1;           // headless turns
+const int PROFILE_HANDLE_PROPERTY = 2;
+const int PROFILE_CALCULATE_RENT = 3;
+const int PROFILE_BUILD_HOUSE = 4;
+const int PROFILE_TRADE_PROPERTIES = 5;
+const int PROFILE_HANDLE_BANKRUPTCY = 6;
+const int PROFILE_SAVE_GAME = 7;
+const int NUM_PROFILE_POINTS = 8;
+const char* const PROFILE_NAMES[NUM_PROFILE_POINTS] = {
+    "processPlayerTurn", "playTurn", "handleProperty", "calculateRent",
+    "buildHouse", "tradeProperties", "handleBankruptcy", "saveGame"
+};
+
+#ifdef MONOPOLY_PROFILE
+
+struct ProfileCounter {
+    long long calls;
+    long long totalNanoseconds; // including instrumented callees
+    long long selfNanoseconds;  // excluding them
+    Histogram latency;          // nanoseconds per call
+};
+
+// One per thread while it runs, added to the process totals when it ends
+struct ProfileCounters {
+    ProfileCounter points[NUM_PROFILE_POINTS];
+    ~ProfileCounters();
+};
+
+// Lives for one call of an instrumented function
+struct ProfileScope {
+    explicit ProfileScope(int point);
+    ~ProfileScope();
+    
+    int point;
+    long long start;
+    long long childNanoseconds;
+    ProfileScope* parent;
+};
+
+#define PROFILE_SCOPE(point) ProfileScope profileScope(point)
+
+#else
+
+#define PROFILE_SCOPE(point) ((void)0)
+
+#endif
+
+#endif
@@ -0,0 +1,232 @@
+#include "replay.h"
+#include "savefile.h"
+#include "turn.h"
+#include <chrono>
+#include <vector>
+
+static void appendReplay(Replay* replay, const JournalRecord* record) {
+    if (replay->pendingLength + JOURNAL_RECORD_SIZE > REPLAY_BUFFER_SIZE) {
+        replay->file.write(reinterpret_cast<const char*>(replay->pending), replay->pendingLength);
+        replay->pendingLength = 0;
+    }
+    encodeRecord(record, replay->pending + replay->pendingLength);
+    replay->pendingLength += JOURNAL_RECORD_SIZE;
+}
+
+// Must be called at a turn boundary
+bool openReplay(Replay* replay, GameState* game, const string& filename) {
+    unsigned char bytes[JOURNAL_RECORD_SIZE + MAX_SAVE_SIZE];
+    int length = encodeGame(game, bytes + JOURNAL_RECORD_SIZE, MAX_SAVE_SIZE);
+    JournalRecord header = {JOURNAL_CHECKPOINT, 0, 0, 0, length};
+    encodeRecord(&header, bytes);
+    
+    game->replay = 0;
+    replay->pendingLength = 0;
+    replay->file.open(filename, ios::binary | ios::trunc);
+    replay->file.write(reinterpret_cast<const char*>(bytes), JOURNAL_RECORD_SIZE + length);
+    replay->file.flush();
+    if (length == 0 || !replay->file) {
+        replay->file.close();
+        cout << "Warning: could not create the replay file. This game won't be recorded.\n";
+        return false;
+    }
+    game->replay = replay;
+    return true;
+}
+
+void closeReplay(Replay* replay, GameState* game) {
+    if (game->replay != replay) {
+        return;
+    }
+    replay->file.close();
+    game->replay = 0;
+}
+
+// Engine changes made while the turn waits on a roll are the player's
+// own actions; anything else the replay recomputes
+void recordReplayAction(GameState* game, const JournalRecord* record) {
+    if (game->turn.decision == DECISION_ROLL &&
+        (record->type == JOURNAL_BUILD || record->type == JOURNAL_MORTGAGE || record->type == JOURNAL_TRADE)) {
+        appendReplay(game->replay, record);
+    }
+}
+
+void recordReplayAnswer(GameState* game, int answer) {
+    JournalRecord record = {
+        REPLAY_ANSWER, static_cast<unsigned char>(game->currentPlayer),
+        game->turn.decision, static_cast<unsigned char>(answer), 0
+    };
+    appendReplay(game->replay, &record);
+}
+
+// Called by finishTurn once the next player is up
+void commitReplayTurn(GameState* game, bool abandoned) {
+    Replay* replay = game->replay;
+    if (abandoned) {
+        JournalRecord record = {REPLAY_END_TURN, 0, 0, 0, 0};
+        appendReplay(replay, &record);
+    }
+    JournalRecord record = {
+        JOURNAL_TURN, 0, 0, static_cast<unsigned char>(game->currentPlayer),
+        static_cast<int>(stateHash(game))
+    };
+    appendReplay(replay, &record);
+    replay->file.write(reinterpret_cast<const char*>(replay->pending), replay->pendingLength);
+    replay->file.flush();
+    replay->pendingLength = 0;
+}
+
+// Checksum of everything a save holds
+unsigned int stateHash(const GameState* game) {
+    unsigned char bytes[MAX_SAVE_SIZE];
+    int length = encodeGame(game, bytes, MAX_SAVE_SIZE);
+    return crc32(bytes, length);
+}
+
+// Takes a recorded action again. Returns false if the engine refuses it.
+static bool replayAction(GameState* game, const Property board[], const JournalRecord* record) {
+    int square = record->square;
+    
+    if (record->type == JOURNAL_TRADE) {
+        TradeOffer offer = tradeFromRecord(record);
+        return offer.fromPlayer < game->numPlayers && offer.toPlayer < game->numPlayers &&
+               executeTrade(game, board, &offer);
+    }
+    if (record->player != game->currentPlayer || square >= game->board->size) {
+        return false;
+    }
+    if (record->type == JOURNAL_BUILD) {
+        if (record->amount < 0) {
+            buildHouse(game, board, square);
+        } else {
+            sellHouse(game, board, square);
+        }
+        return game->squares[square].houses == record->value;
+    }
+    if (record->type != JOURNAL_MORTGAGE) {
+        return false;
+    }
+    if (record->value != 0) {
+        mortgageProperty(game, board, square);
+    } else {
+        unmortgageProperty(game, board, square);
+    }
+    return game->squares[square].mortgaged == (record->value != 0);
+}
+
+static ReplayResult failReplay(ReplayResult result, const string& error) {
+    result.diverged = true;
+    result.error = error;
+    return result;
+}
+
+static ReplayResult divergedAt(ReplayResult result, const string& error) {
+    return failReplay(result, "turn " + to_string(result.turns + 1) + ": " + error);
+}
+
+// Plays a recorded game again, headless and with no players: every
+// decision comes from the file. With verify, the state hash is checked
+// after every turn as well as the decisions themselves.
+ReplayResult runReplay(const string& filename, bool verify) {
+    ReplayResult result = {0, false, ""};
+    
+    ifstream inFile(filename, ios::binary);
+    if (!inFile) {
+        return failReplay(result, "cannot open the file");
+    }
+    vector<unsigned char> data((istreambuf_iterator<char>(inFile)), istreambuf_iterator<char>());
+    inFile.close();
+    
+    JournalRecord record;
+    if (data.size() < static_cast<size_t>(JOURNAL_RECORD_SIZE)) {
+        return failReplay(result, "not a replay");
+    }
+    decodeRecord(data.data(), &record);
+    size_t offset = JOURNAL_RECORD_SIZE + record.amount;
+    if (record.type != JOURNAL_CHECKPOINT || record.amount <= 0 || record.amount > MAX_SAVE_SIZE ||
+        offset > data.size()) {
+        return failReplay(result, "not a replay");
+    }
+    
+    GameState game;
+    PlayerNames names;
+    memset(&game, 0, sizeof(GameState));
+    game.board = activeBoard;
+    int status = decodeGame(data.data() + JOURNAL_RECORD_SIZE, record.amount, &game, &names);
+    if (status == SAVE_WRONG_BOARD) {
+        return failReplay(result, "recorded on a different board");
+    }
+    if (status != SAVE_OK) {
+        return failReplay(result, "bad starting state");
+    }
+    game.outputLevel = OUTPUT_SILENT;
+    const Property* board = game.board->squares;
+    rebuildOwnershipIndex(&game, board);
+    
+    while (offset + JOURNAL_RECORD_SIZE <= data.size()) {
+        int decision = runTurn(&game, board);
+        
+        while (decision != DECISION_NONE) {
+            if (offset + JOURNAL_RECORD_SIZE > data.size()) {
+                return result; // the recording stopped mid-turn
+            }
+            decodeRecord(data.data() + offset, &record);
+            offset += JOURNAL_RECORD_SIZE;
+            
+            if (record.type == REPLAY_ANSWER) {
+                if (record.square != decision) {
+                    return divergedAt(result, "engine asked for decision " + to_string(decision) +
+                                              ", recording answered " + to_string(record.square));
+                }
+                decision = resumeTurn(&game, board, record.value);
+            } else if (record.type == REPLAY_END_TURN && decision == DECISION_ROLL) {
+                finishTurn(&game);
+                decision = DECISION_NONE;
+            } else if (decision != DECISION_ROLL || !replayAction(&game, board, &record)) {
+                return divergedAt(result, "recorded action (type " + to_string(record.type) +
+                                          ") does not fit the game");
+            }
+        }
+        
+        if (offset + JOURNAL_RECORD_SIZE > data.size()) {
+            return result;
+        }
+        decodeRecord(data.data() + offset, &record);
+        offset += JOURNAL_RECORD_SIZE;
+        if (record.type != JOURNAL_TURN || record.value != game.currentPlayer) {
+            return divergedAt(result, "turn ended differently");
+        }
+        if (verify && static_cast<unsigned int>(record.amount) != stateHash(&game)) {
+            return divergedAt(result, "state differs after the turn");
+        }
+        result.turns++;
+    }
+    return result;
+}
+
+// Replays a list of files and reports the ones that diverge. Returns the
+// process exit code: 0 if every replay matched.
+int runReplays(char* filenames[], int count, bool verify) {
+    auto start = chrono::steady_clock::now();
+    long long totalTurns = 0;
+    int diverged = 0;
+    
+    for (int i = 0; i < count; i++) {
+        ReplayResult result = runReplay(filenames[i], verify);
+        totalTurns += result.turns;
+        if (result.diverged) {
+            cout << filenames[i] << ": " << result.error << '\n';
+            diverged++;
+        }
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    
+    cout << "Replayed " << count << " games (" << totalTurns << " turns"
+         << (verify ? ", states verified" : "") << ") in " << seconds << "s";
+    if (seconds > 0) {
+        cout << " (" << static_cast<long long>(totalTurns / seconds) << " turns/sec)";
+    }
+    cout << '\n';
+    cout << (diverged == 0 ? "All replays matched.\n" : to_string(diverged) + " replays diverged.\n");
+    return diverged == 0 ? 0 : 1;
+}
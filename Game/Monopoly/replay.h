@@ -0,0 +1,51 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include "journal.h"
+
+// A replay file is the state a game started from plus every decision its
+// players made, so the game can be played again without them. Dice come
+// from the generator in the starting state and everything else follows
+// from the engine, so a replay reproduces the game exactly as long as the
+// engine plays the same way, and shows where it first doesn't.
+//
+// It uses the journal's record format (see journal.h):
+//   CHECKPOINT  the starting state, as in a journal
+//   BUILD, MORTGAGE, TRADE
+//               actions taken while the turn waited on DECISION_ROLL
+//   ANSWER      square = decision, value = answer given to resumeTurn
+//   END_TURN    the turn was given up at DECISION_ROLL
+//   TURN        value = next player, amount = state hash after the turn
+//
+// Console games run with --record write one file per game started,
+// loaded or recovered.
+const int REPLAY_BUFFER_SIZE = 512;
+
+// Replay-only record types, numbered after the undo log's
+const int REPLAY_ANSWER = 16;
+const int REPLAY_END_TURN = 17;
+
+// Records are buffered and written once per turn, like the journal's
+struct Replay {
+    ofstream file;
+    unsigned char pending[REPLAY_BUFFER_SIZE];
+    int pendingLength;
+};
+
+struct ReplayResult {
+    int turns;     // turns replayed
+    bool diverged; // the engine didn't play the game as recorded
+    string error;  // what went wrong, if anything
+};
+
+// Function declarations
+bool openReplay(Replay*, GameState*, const string&);
+void closeReplay(Replay*, GameState*);
+void recordReplayAction(GameState*, const JournalRecord*);
+void recordReplayAnswer(GameState*, int);
+void commitReplayTurn(GameState*, bool);
+unsigned int stateHash(const GameState*);
+ReplayResult runReplay(const string&, bool);
+int runReplays(char*[], int, bool);
+
+#endif
@@ -0,0 +1,336 @@
+#include "savefile.h"
+#include "board.h"
+#include "turn.h"
+
+struct CrcTable {
+    unsigned int entries[256];
+};
+
+constexpr CrcTable makeCrcTable() {
+    CrcTable table = {};
+    for (unsigned int i = 0; i < 256; i++) {
+        unsigned int c = i;
+        for (int k = 0; k < 8; k++) {
+            c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        }
+        table.entries[i] = c;
+    }
+    return table;
+}
+
+constexpr CrcTable CRC_TABLE = makeCrcTable();
+
+unsigned int crc32(const unsigned char* data, int length) {
+    unsigned int c = 0xFFFFFFFFu;
+    for (int i = 0; i < length; i++) {
+        c = CRC_TABLE.entries[(c ^ data[i]) & 0xFF] ^ (c >> 8);
+    }
+    return c ^ 0xFFFFFFFFu;
+}
+
+// Byte writer/reader with bounds checking
+struct SaveWriter {
+    unsigned char* data;
+    int capacity;
+    int length;
+    bool overflow;
+};
+
+struct SaveReader {
+    const unsigned char* data;
+    int length;
+    int offset;
+    bool overrun;
+};
+
+static void putByte(SaveWriter* writer, int value) {
+    if (writer->length >= writer->capacity) {
+        writer->overflow = true;
+        return;
+    }
+    writer->data[writer->length++] = static_cast<unsigned char>(value);
+}
+
+static void putInt(SaveWriter* writer, unsigned int value, int bytes) {
+    for (int i = 0; i < bytes; i++) {
+        putByte(writer, (value >> (8 * i)) & 0xFF);
+    }
+}
+
+static int getByte(SaveReader* reader) {
+    if (reader->offset >= reader->length) {
+        reader->overrun = true;
+        return 0;
+    }
+    return reader->data[reader->offset++];
+}
+
+static unsigned int getInt(SaveReader* reader, int bytes) {
+    unsigned int value = 0;
+    for (int i = 0; i < bytes; i++) {
+        value |= static_cast<unsigned int>(getByte(reader)) << (8 * i);
+    }
+    return value;
+}
+
+// Square byte: bits 0-2 owner + 1 (0 = bank), bits 3-5 houses, bit 6 mortgaged
+static int packSquare(const SquareState* square) {
+    return (square->owner + 1) | (square->houses << 3) | (square->mortgaged ? 0x40 : 0);
+}
+
+// Writes the game into buffer; returns the number of bytes, or 0 if it
+// doesn't fit
+int encodeGame(const GameState* game, unsigned char buffer[], int capacity) {
+    SaveWriter writer = {buffer, capacity, SAVE_HEADER_SIZE, capacity < SAVE_HEADER_SIZE};
+    
+    putInt(&writer, game->board->id, 4);
+    putByte(&writer, game->numPlayers);
+    putByte(&writer, game->currentPlayer);
+    for (int deck = 0; deck < NUM_DECKS; deck++) {
+        putByte(&writer, game->deckIndex[deck]);
+    }
+    for (int deck = 0; deck < NUM_DECKS; deck++) {
+        for (int i = 0; i < DECK_SIZE; i++) {
+            putByte(&writer, game->deckOrder[deck][i]);
+        }
+    }
+    
+    for (int i = 0; i < game->numPlayers; i++) {
+        const Player* player = &game->players[i];
+        const char* name = playerName(game, i);
+        int nameLength = static_cast<int>(strnlen(name, MAX_NAME_LENGTH - 1));
+        
+        putInt(&writer, static_cast<unsigned int>(player->money), 4);
+        putByte(&writer, player->position);
+        putByte(&writer, player->jailTurns);
+        putByte(&writer, player->getOutOfJailCards);
+        putByte(&writer, (player->inJail ? 1 : 0) | (player->bankrupt ? 2 : 0) | (player->computer ? 4 : 0));
+        putByte(&writer, nameLength);
+        for (int j = 0; j < nameLength; j++) {
+            putByte(&writer, name[j]);
+        }
+        
+        // Holdings keep their order so menu numbers survive
+        putByte(&writer, player->propertyCount);
+        for (int j = 0; j < player->propertyCount; j++) {
+            putByte(&writer, static_cast<unsigned char>(player->ownedProperties[j]));
+        }
+    }
+    
+    for (int i = 0; i < game->board->size; i++) {
+        putByte(&writer, packSquare(&game->squares[i]));
+    }
+    
+    for (int i = 0; i < 4; i++) {
+        putInt(&writer, static_cast<unsigned int>(game->dice.rng.s[i]), 4);
+        putInt(&writer, static_cast<unsigned int>(game->dice.rng.s[i] >> 32), 4);
+    }
+    putByte(&writer, DICE_BUFFER_SIZE - game->dice.next);
+    for (int i = game->dice.next; i < DICE_BUFFER_SIZE; i++) {
+        putByte(&writer, game->dice.pairs[i]);
+    }
+    
+    if (writer.overflow) {
+        return 0;
+    }
+    
+    int payloadLength = writer.length - SAVE_HEADER_SIZE;
+    unsigned int checksum = crc32(buffer + SAVE_HEADER_SIZE, payloadLength);
+    writer.length = 0;
+    for (int i = 0; i < 4; i++) {
+        putByte(&writer, SAVE_MAGIC[i]);
+    }
+    putInt(&writer, SAVE_VERSION, 2);
+    putInt(&writer, payloadLength, 2);
+    putInt(&writer, checksum, 4);
+    
+    return SAVE_HEADER_SIZE + payloadLength;
+}
+
+static bool isValidPair(int pair) {
+    int die1 = pair >> 4;
+    int die2 = pair & 0xF;
+    return die1 >= 1 && die1 <= 6 && die2 >= 1 && die2 <= 6;
+}
+
+// Checks and decodes a save of a game on game->board. Nothing is written to
+// game or names unless the whole file is valid.
+int decodeGame(const unsigned char buffer[], int length, GameState* game, PlayerNames* names) {
+    if (length < SAVE_HEADER_SIZE || memcmp(buffer, SAVE_MAGIC, 4) != 0) {
+        return SAVE_NOT_A_SAVE;
+    }
+    
+    SaveReader header = {buffer, SAVE_HEADER_SIZE, 4, false};
+    int version = getInt(&header, 2);
+    int payloadLength = getInt(&header, 2);
+    unsigned int checksum = getInt(&header, 4);
+    
+    if (version < 1 || version > SAVE_VERSION) {
+        return SAVE_WRONG_VERSION;
+    }
+    if (payloadLength != length - SAVE_HEADER_SIZE ||
+        crc32(buffer + SAVE_HEADER_SIZE, payloadLength) != checksum) {
+        return SAVE_CORRUPT;
+    }
+    
+    GameState loaded = *game;
+    PlayerNames loadedNames;
+    memset(&loadedNames, 0, sizeof(PlayerNames));
+    SaveReader reader = {buffer + SAVE_HEADER_SIZE, payloadLength, 0, false};
+    const Board* board = game->board;
+    
+    // Saves from before boards could be loaded are all on the standard one
+    unsigned int boardId = version >= 3 ? getInt(&reader, 4) : STANDARD_BOARD.id;
+    if (boardId != board->id) {
+        return SAVE_WRONG_BOARD;
+    }
+    loaded.numPlayers = getByte(&reader);
+    loaded.currentPlayer = getByte(&reader);
+    if (loaded.numPlayers < 2 || loaded.numPlayers > MAX_PLAYERS ||
+        loaded.currentPlayer >= loaded.numPlayers) {
+        return SAVE_CORRUPT;
+    }
+    for (int deck = 0; deck < NUM_DECKS; deck++) {
+        loaded.deckIndex[deck] = getByte(&reader);
+        if (loaded.deckIndex[deck] >= DECK_SIZE) {
+            return SAVE_CORRUPT;
+        }
+    }
+    for (int deck = 0; deck < NUM_DECKS; deck++) {
+        // Each card exactly once
+        unsigned int seen = 0;
+        for (int i = 0; i < DECK_SIZE; i++) {
+            int card = version >= 2 ? getByte(&reader) : i;
+            if (card >= DECK_SIZE || (seen & (1u << card))) {
+                return SAVE_CORRUPT;
+            }
+            seen |= 1u << card;
+            loaded.deckOrder[deck][i] = card;
+        }
+    }
+    
+    for (int i = 0; i < loaded.numPlayers; i++) {
+        Player* player = &loaded.players[i];
+        initializePlayer(player, 0);
+        
+        player->money = static_cast<int>(getInt(&reader, 4));
+        player->position = getByte(&reader);
+        player->jailTurns = getByte(&reader);
+        player->getOutOfJailCards = getByte(&reader);
+        int flags = getByte(&reader);
+        player->inJail = (flags & 1) != 0;
+        player->bankrupt = (flags & 2) != 0;
+        player->computer = (flags & 4) != 0;
+        
+        int nameLength = getByte(&reader);
+        if (nameLength >= MAX_NAME_LENGTH) {
+            return SAVE_CORRUPT;
+        }
+        for (int j = 0; j < nameLength; j++) {
+            loadedNames.name[i][j] = static_cast<char>(getByte(&reader));
+        }
+        
+        // Saves from before the lists were kept dense may have -1 holes
+        int listed = getByte(&reader);
+        if (listed > board->size) {
+            return SAVE_CORRUPT;
+        }
+        player->propertyCount = 0;
+        for (int j = 0; j < listed; j++) {
+            int propertyIndex = static_cast<signed char>(getByte(&reader));
+            if (propertyIndex < -1 || propertyIndex >= board->size) {
+                return SAVE_CORRUPT;
+            }
+            if (propertyIndex != -1) {
+                player->ownedProperties[player->propertyCount++] = propertyIndex;
+            }
+        }
+        
+        if (player->position >= board->size || player->jailTurns > 3 || flags > 7) {
+            return SAVE_CORRUPT;
+        }
+    }
+    
+    for (int i = 0; i < board->size; i++) {
+        int packed = getByte(&reader);
+        SquareState* square = &loaded.squares[i];
+        square->owner = static_cast<signed char>((packed & 0x07) - 1);
+        square->houses = (packed >> 3) & 0x07;
+        square->mortgaged = (packed & 0x40) != 0;
+        
+        if (square->owner >= loaded.numPlayers || square->houses > HOTEL || (packed & 0x80)) {
+            return SAVE_CORRUPT;
+        }
+        // Only properties are owned, and only owned, unmortgaged streets built on
+        int type = board->squares[i].type;
+        if ((square->owner != -1 && (type < 1 || type > 3)) ||
+            (square->houses > 0 && (type != 1 || square->owner == -1 || square->mortgaged))) {
+            return SAVE_CORRUPT;
+        }
+    }
+    
+    // Each owned square is listed once, by its owner
+    SquareMask listedSquares = 0;
+    SquareMask ownedSquares = 0;
+    for (int i = 0; i < loaded.numPlayers; i++) {
+        const Player* player = &loaded.players[i];
+        for (int j = 0; j < player->propertyCount; j++) {
+            int propertyIndex = player->ownedProperties[j];
+            if (loaded.squares[propertyIndex].owner != i || (listedSquares & squareBit(propertyIndex))) {
+                return SAVE_CORRUPT;
+            }
+            listedSquares |= squareBit(propertyIndex);
+        }
+    }
+    for (int i = 0; i < board->size; i++) {
+        if (loaded.squares[i].owner != -1) {
+            ownedSquares |= squareBit(i);
+        }
+    }
+    if (listedSquares != ownedSquares) {
+        return SAVE_CORRUPT;
+    }
+    
+    for (int i = 0; i < 4; i++) {
+        unsigned long long low = getInt(&reader, 4);
+        unsigned long long high = getInt(&reader, 4);
+        loaded.dice.rng.s[i] = low | (high << 32);
+    }
+    int buffered = getByte(&reader);
+    if (buffered > DICE_BUFFER_SIZE) {
+        return SAVE_CORRUPT;
+    }
+    loaded.dice.next = DICE_BUFFER_SIZE - buffered;
+    for (int i = loaded.dice.next; i < DICE_BUFFER_SIZE; i++) {
+        loaded.dice.pairs[i] = getByte(&reader);
+        if (!isValidPair(loaded.dice.pairs[i])) {
+            return SAVE_CORRUPT;
+        }
+    }
+    
+    if (reader.overrun || reader.offset != reader.length) {
+        return SAVE_CORRUPT;
+    }
+    
+    loaded.names = names;
+    loaded.gameOver = false;
+    // Saves hold no turn state: the current player's turn starts afresh
+    startTurn(&loaded);
+    *game = loaded;
+    *names = loadedNames;
+    return SAVE_OK;
+}
+
+// What went wrong, to follow "The save file": SAVE_* other than SAVE_OK
+const char* saveErrorMessage(int result) {
+    switch (result) {
+        case SAVE_NOT_A_SAVE:
+            return "is not a Monopoly save or uses an old format";
+        case SAVE_WRONG_VERSION:
+            return "was written by a different version of the game";
+        case SAVE_WRONG_BOARD:
+            return "is for a different board";
+        default:
+            return "is corrupt";
+    }
+}
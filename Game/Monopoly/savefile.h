@@ -0,0 +1,32 @@
+#ifndef SAVEFILE_H
+#define SAVEFILE_H
+
+#include "monopoly.h"
+
+// Save file layout (all integers little-endian):
+//   header:  magic "MNPL", version (2 bytes), payload length (2 bytes),
+//            CRC-32 of the payload (4 bytes)
+//   payload: board id, game counters, the order of both card decks,
+//            players with names and holdings lists, one byte per square,
+//            dice generator and any unused pre-rolled pairs
+// Version 1 saves have no deck orders and load with the decks unshuffled.
+// Saves before version 3 have no board id and are on the standard board.
+const unsigned char SAVE_MAGIC[4] = {'M', 'N', 'P', 'L'};
+const int SAVE_VERSION = 3;
+const int SAVE_HEADER_SIZE = 12;
+const int MAX_SAVE_SIZE = 1024;
+
+// Decoding results
+const int SAVE_OK = 0;
+const int SAVE_NOT_A_SAVE = 1;
+const int SAVE_WRONG_VERSION = 2;
+const int SAVE_CORRUPT = 3;
+const int SAVE_WRONG_BOARD = 4; // a save of a game on another board
+
+// Function declarations
+unsigned int crc32(const unsigned char*, int);
+int encodeGame(const GameState*, unsigned char[], int);
+int decodeGame(const unsigned char[], int, GameState*, PlayerNames*);
+const char* saveErrorMessage(int);
+
+#endif
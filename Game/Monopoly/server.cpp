@@ -0,0 +1,513 @@
+#include "server.h"
+#include "turn.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+#include <sstream>
+#include <cerrno>
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+// One hosted game. The slot's lock is held for the whole of each command,
+// so a game is only ever touched by one worker at a time; inUse is only
+// changed under it.
+struct GameSlot {
+    mutex lock;
+    bool inUse;
+    GameState game;
+};
+
+// Connection state shared between the poll loop and the workers. While a
+// command is in flight only the worker running it touches the connection,
+// apart from the output buffer, which is guarded by lock.
+struct Connection {
+    int fd;
+    string input;
+    mutex lock;
+    string output;
+    bool inFlight;
+    bool closing;
+};
+
+struct Task {
+    Connection* connection;
+    string command;
+};
+
+struct Server {
+    vector<GameSlot> slots;
+    mutex freeLock;
+    vector<int> freeSlots;
+    
+    mutex tasksLock;
+    condition_variable tasksReady;
+    deque<Task> tasks;
+    
+    int wakeFds[2]; // workers write a byte here when a reply is ready
+    
+    Server(int numGames) : slots(numGames) {}
+};
+
+// Locks and returns the slot for a game id, or null if there is no such game
+static GameSlot* lockGame(Server* server, int id, unique_lock<mutex>* guard) {
+    if (id < 0 || id >= static_cast<int>(server->slots.size())) {
+        return 0;
+    }
+    GameSlot* slot = &server->slots[id];
+    *guard = unique_lock<mutex>(slot->lock);
+    if (!slot->inUse) {
+        guard->unlock();
+        return 0;
+    }
+    return slot;
+}
+
+static string newGame(Server* server, istringstream& args) {
+    int numPlayers = 0;
+    unsigned long long seed = static_cast<unsigned long long>(time(0));
+    args >> numPlayers;
+    if (numPlayers < 2 || numPlayers > MAX_PLAYERS) {
+        return "ERR players must be 2-4";
+    }
+    args >> seed;
+    
+    int id;
+    {
+        lock_guard<mutex> guard(server->freeLock);
+        if (server->freeSlots.empty()) {
+            return "ERR server full";
+        }
+        id = server->freeSlots.back();
+        server->freeSlots.pop_back();
+    }
+    
+    GameSlot* slot = &server->slots[id];
+    lock_guard<mutex> guard(slot->lock);
+    // Every decision comes from the client, so the game has no controllers
+    setupHeadlessGame(&slot->game, activeBoard, numPlayers, 0, seed);
+    runTurn(&slot->game, slot->game.board->squares);
+    slot->inUse = true;
+    return "OK " + to_string(id);
+}
+
+// Reply for where a turn stopped. A finished turn reports the player's
+// result and starts the next turn, so an unfinished game is always
+// waiting on a decision.
+static string turnReply(GameState* game, int playerNum, int decision) {
+    if (decision == DECISION_BUY) {
+        return "ASK BUY " + to_string(game->turn.square);
+    } else if (decision == DECISION_JAIL) {
+        return "ASK JAIL";
+    } else if (decision == DECISION_ROLL) {
+        return "ASK ROLL"; // doubles
+    }
+    
+    const Property* board = game->board->squares;
+    const Player* player = &game->players[playerNum];
+    string reply = "OK " + to_string(playerNum) + " " + to_string(player->position) + " " +
+                   to_string(player->money);
+    if (checkWinCondition(game)) {
+        game->gameOver = true;
+        reply += " " + to_string(game->currentPlayer);
+        for (int i = 0; i < game->numPlayers; i++) {
+            if (!game->players[i].bankrupt) {
+                reply += " OVER " + to_string(i);
+            }
+        }
+        return reply;
+    }
+    
+    // Bankrupt players' turns finish straight away
+    for (int i = 0; i < game->numPlayers && runTurn(game, board) == DECISION_NONE; i++) {
+    }
+    return reply + " " + to_string(game->currentPlayer);
+}
+
+static string rollForPlayer(GameSlot* slot) {
+    GameState* game = &slot->game;
+    if (game->gameOver) {
+        return "ERR game over";
+    }
+    if (game->turn.decision != DECISION_ROLL) {
+        return game->gameOver ? "ERR game over" : "ERR waiting for ANSWER";
+    }
+    
+    int playerNum = game->currentPlayer;
+    return turnReply(game, playerNum, resumeTurn(game, game->board->squares, 0));
+}
+
+static string answerForPlayer(GameSlot* slot, istringstream& args) {
+    GameState* game = &slot->game;
+    string text;
+    args >> text;
+    if (game->gameOver) {
+        return "ERR game over";
+    }
+    
+    int answer = -1;
+    if (game->turn.decision == DECISION_BUY) {
+        if (text == "y" || text == "n") {
+            answer = (text == "y");
+        }
+    } else if (game->turn.decision == DECISION_JAIL) {
+        if (text == "1" || text == "2" || text == "3") {
+            answer = text[0] - '0';
+        }
+    } else {
+        return "ERR waiting for ROLL";
+    }
+    if (answer == -1) {
+        return "ERR usage: ANSWER <game> <y|n> for BUY, <1|2|3> for JAIL";
+    }
+    
+    int playerNum = game->currentPlayer;
+    return turnReply(game, playerNum, resumeTurn(game, game->board->squares, answer));
+}
+
+// BUILD, SELL, MORTGAGE and UNMORTGAGE. The engine functions report
+// refusals as events, so success is judged by whether the square changed.
+static string manageProperty(GameSlot* slot, const string& command, istringstream& args) {
+    GameState* game = &slot->game;
+    if (game->turn.decision != DECISION_ROLL) {
+        return game->gameOver ? "ERR game over" : "ERR waiting for ANSWER";
+    }
+    int square = -1;
+    args >> square;
+    if (square < 0 || square >= game->board->size) {
+        return "ERR bad square";
+    }
+    
+    const Property* board = game->board->squares;
+    SquareState before = game->squares[square];
+    if (command == "BUILD") {
+        buildHouse(game, board, square);
+    } else if (command == "SELL") {
+        sellHouse(game, board, square);
+    } else if (command == "MORTGAGE") {
+        mortgageProperty(game, board, square);
+    } else {
+        unmortgageProperty(game, board, square);
+    }
+    
+    const SquareState* after = &game->squares[square];
+    if (after->houses == before.houses && after->mortgaged == before.mortgaged) {
+        return "ERR refused";
+    }
+    return "OK " + to_string(game->players[game->currentPlayer].money);
+}
+
+// Holdings slot of a square in a player's list, -1 for "-", -2 if not held
+static int holdingsSlot(const GameState* game, int playerNum, const string& square) {
+    if (square == "-") {
+        return -1;
+    }
+    int index = atoi(square.c_str());
+    if (index < 0 || index >= game->board->size || game->squares[index].owner != playerNum) {
+        return -2;
+    }
+    return game->squares[index].slot;
+}
+
+static string tradeForPlayers(GameSlot* slot, istringstream& args) {
+    GameState* game = &slot->game;
+    if (game->turn.decision != DECISION_ROLL) {
+        return game->gameOver ? "ERR game over" : "ERR waiting for ANSWER";
+    }
+    string offered, requested;
+    TradeOffer offer;
+    offer.fromPlayer = game->currentPlayer;
+    offer.toPlayer = -1;
+    offer.offeredMoney = -1;
+    offer.requestedMoney = -1;
+    args >> offer.toPlayer >> offered >> requested >> offer.offeredMoney >> offer.requestedMoney;
+    
+    if (offer.toPlayer < 0 || offer.toPlayer >= game->numPlayers || offer.toPlayer == offer.fromPlayer ||
+        offer.offeredMoney < 0 || offer.requestedMoney < 0) {
+        return "ERR usage: TRADE <game> <to> <square|-> <square|-> <money> <money>";
+    }
+    offer.offeredProperty = holdingsSlot(game, offer.fromPlayer, offered);
+    offer.requestedProperty = holdingsSlot(game, offer.toPlayer, requested);
+    if (offer.offeredProperty == -2 || offer.requestedProperty == -2) {
+        return "ERR square not owned";
+    }
+    
+    if (!executeTrade(game, game->board->squares, &offer)) {
+        return "ERR refused";
+    }
+    return "OK";
+}
+
+static string describeGame(const GameSlot* slot) {
+    const GameState* game = &slot->game;
+    string reply = "OK " + to_string(game->currentPlayer);
+    for (int i = 0; i < game->numPlayers; i++) {
+        const Player* player = &game->players[i];
+        reply += " " + to_string(player->money) + ":" + to_string(player->position) + ":" +
+                 to_string(player->inJail) + ":" + to_string(player->bankrupt);
+    }
+    
+    // One character per square: owner number, or '-' for the bank
+    reply += " ";
+    for (int i = 0; i < game->board->size; i++) {
+        int owner = game->squares[i].owner;
+        reply += (owner == -1) ? '-' : static_cast<char>('0' + owner);
+    }
+    return reply;
+}
+
+static string executeCommand(Server* server, const string& line) {
+    istringstream args(line);
+    string command;
+    args >> command;
+    
+    if (command == "NEW") {
+        return newGame(server, args);
+    }
+    
+    int id = -1;
+    args >> id;
+    unique_lock<mutex> guard;
+    GameSlot* slot = lockGame(server, id, &guard);
+    if (!slot) {
+        return "ERR no such game";
+    }
+    
+    if (command == "ROLL") {
+        return rollForPlayer(slot);
+    } else if (command == "ANSWER") {
+        return answerForPlayer(slot, args);
+    } else if (command == "BUILD" || command == "SELL" || command == "MORTGAGE" || command == "UNMORTGAGE") {
+        return manageProperty(slot, command, args);
+    } else if (command == "TRADE") {
+        return tradeForPlayers(slot, args);
+    } else if (command == "STATE") {
+        return describeGame(slot);
+    } else if (command == "END") {
+        slot->inUse = false;
+        lock_guard<mutex> freeGuard(server->freeLock);
+        server->freeSlots.push_back(id);
+        return "OK";
+    }
+    return "ERR unknown command";
+}
+
+static void workerLoop(Server* server) {
+    while (true) {
+        Task task;
+        {
+            unique_lock<mutex> guard(server->tasksLock);
+            server->tasksReady.wait(guard, [server] { return !server->tasks.empty(); });
+            task = server->tasks.front();
+            server->tasks.pop_front();
+        }
+        
+        string reply = executeCommand(server, task.command) + "\n";
+        {
+            lock_guard<mutex> guard(task.connection->lock);
+            task.connection->output += reply;
+            task.connection->inFlight = false;
+        }
+        char wake = 0;
+        if (write(server->wakeFds[1], &wake, 1) < 0) {
+            // The pipe is full, so the loop is already due to wake up
+        }
+    }
+}
+
+// Hands the connection's next complete line to the workers, if it has one
+// and nothing else is in flight. Returns false if the client asked to quit
+// or sent an overlong line.
+static bool dispatchCommand(Server* server, Connection* connection) {
+    lock_guard<mutex> guard(connection->lock);
+    size_t end = connection->input.find('\n');
+    if (end == string::npos && connection->input.size() > static_cast<size_t>(MAX_COMMAND_LENGTH)) {
+        connection->input.clear();
+        return false;
+    }
+    if (connection->inFlight || end == string::npos) {
+        return true;
+    }
+    string command = connection->input.substr(0, end);
+    connection->input.erase(0, end + 1);
+    if (!command.empty() && command.back() == '\r') {
+        command.pop_back();
+    }
+    if (command == "QUIT") {
+        connection->input.clear();
+        return false;
+    }
+    
+    connection->inFlight = true;
+    lock_guard<mutex> tasksGuard(server->tasksLock);
+    server->tasks.push_back(Task{connection, command});
+    server->tasksReady.notify_one();
+    return true;
+}
+
+// Writes as much pending output as the socket takes. Output a client that
+// has gone can't take is dropped; the commands it sent still run.
+static void sendOutput(Connection* connection) {
+    lock_guard<mutex> guard(connection->lock);
+    while (!connection->output.empty()) {
+        ssize_t sent = send(connection->fd, connection->output.data(), connection->output.size(), MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                connection->output.clear();
+            }
+            return;
+        }
+        connection->output.erase(0, sent);
+    }
+}
+
+static bool setNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags != -1 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) != -1;
+}
+
+static int openListener(const char* path) {
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(address.sun_path)) {
+        cout << "Socket path is too long.\n";
+        return -1;
+    }
+    strcpy(address.sun_path, path);
+    
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(path);
+    if (fd == -1 || bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == -1 ||
+        listen(fd, SOMAXCONN) == -1 || !setNonBlocking(fd)) {
+        cout << "Could not listen on " << path << ": " << strerror(errno) << "\n";
+        if (fd != -1) close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Runs until killed
+int runServer(const char* path, int numThreads, int numGames) {
+    if (numThreads <= 0) numThreads = DEFAULT_SERVER_THREADS;
+    if (numGames <= 0) numGames = DEFAULT_SERVER_GAMES;
+    
+    Server* server = new Server(numGames);
+    // Lowest ids are handed out first
+    for (int i = numGames - 1; i >= 0; i--) {
+        server->slots[i].inUse = false;
+        server->freeSlots.push_back(i);
+    }
+    if (pipe(server->wakeFds) == -1 || !setNonBlocking(server->wakeFds[0]) || !setNonBlocking(server->wakeFds[1])) {
+        cout << "Could not create wake pipe.\n";
+        return 1;
+    }
+    int listener = openListener(path);
+    if (listener == -1) {
+        return 1;
+    }
+    
+    for (int i = 0; i < numThreads; i++) {
+        thread(workerLoop, server).detach();
+    }
+    cout << "Serving up to " << numGames << " games on " << path
+         << " with " << numThreads << " worker threads\n" << flush;
+    
+    vector<Connection*> connections;
+    vector<pollfd> fds;
+    
+    while (true) {
+        fds.clear();
+        fds.push_back(pollfd{listener, POLLIN, 0});
+        fds.push_back(pollfd{server->wakeFds[0], POLLIN, 0});
+        // Read only when the connection needs more of its next command, so
+        // a client sending ahead waits in the socket buffer, not in input.
+        // A connection waiting on nothing isn't polled at all: poll reports
+        // a hang-up whatever the events, and would return at once until the
+        // command in flight is done.
+        for (Connection* connection : connections) {
+            lock_guard<mutex> guard(connection->lock);
+            bool wantsInput = !connection->closing && !connection->inFlight &&
+                              connection->input.find('\n') == string::npos;
+            short events = wantsInput ? POLLIN : 0;
+            if (!connection->output.empty()) events |= POLLOUT;
+            fds.push_back(pollfd{events != 0 ? connection->fd : -1, events, 0});
+        }
+        
+        if (poll(fds.data(), fds.size(), -1) == -1) {
+            if (errno == EINTR) continue;
+            cout << "poll failed: " << strerror(errno) << "\n";
+            return 1;
+        }
+        
+        if (fds[1].revents & POLLIN) {
+            char drain[64];
+            while (read(server->wakeFds[0], drain, sizeof(drain)) > 0) {
+            }
+        }
+        
+        if (fds[0].revents & POLLIN) {
+            int fd;
+            while ((fd = accept(listener, 0, 0)) != -1) {
+                if (!setNonBlocking(fd)) {
+                    close(fd);
+                    continue;
+                }
+                Connection* connection = new Connection();
+                connection->fd = fd;
+                connection->inFlight = false;
+                connection->closing = false;
+                connections.push_back(connection);
+            }
+        }
+        
+        // Connections accepted above have no pollfd entry yet
+        for (size_t i = 0; i + 2 < fds.size(); i++) {
+            Connection* connection = connections[i];
+            short revents = fds[i + 2].revents;
+            
+            // A client that has hung up, or reset the connection by closing
+            // with replies unread, can still have commands in the socket
+            // buffer. recv hands those over before it reports the end.
+            if ((revents & (POLLIN | POLLHUP | POLLERR)) && (fds[i + 2].events & POLLIN)) {
+                char buffer[4096];
+                ssize_t received = recv(connection->fd, buffer, sizeof(buffer), 0);
+                if (received > 0) {
+                    connection->input.append(buffer, received);
+                } else if (received == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+                    connection->closing = true;
+                }
+            }
+        }
+        
+        // Send replies, start next commands and retire closed connections
+        for (size_t i = 0; i < connections.size(); ) {
+            Connection* connection = connections[i];
+            sendOutput(connection);
+            if (!dispatchCommand(server, connection)) {
+                connection->closing = true;
+            }
+            
+            // A client that sends its commands and closes still gets its replies
+            bool finished;
+            {
+                lock_guard<mutex> guard(connection->lock);
+                finished = connection->closing && !connection->inFlight &&
+                           connection->input.find('\n') == string::npos;
+            }
+            if (finished) {
+                sendOutput(connection);
+                close(connection->fd);
+                delete connection;
+                connections[i] = connections.back();
+                connections.pop_back();
+            } else {
+                i++;
+            }
+        }
+    }
+}
@@ -0,0 +1,33 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include "simulation.h"
+
+// Server mode: many headless games in one process, driven by clients over
+// a Unix-domain socket. One thread runs a poll() loop for all connections;
+// complete command lines are handed to a small pool of worker threads.
+//
+// Protocol: one command per line, one reply line per command, starting
+// with "OK", "ASK" or "ERR". A connection's commands are answered in order.
+//   NEW <players> [seed]                   -> OK <game>
+//   ROLL <game>                            -> ASK ... or OK <player> <position> <money> <next> [OVER <winner>]
+//   ANSWER <game> <y|n> or <1|2|3>         -> same as ROLL
+//   BUILD|SELL|MORTGAGE|UNMORTGAGE <game> <square>   -> OK <money>
+//   TRADE <game> <to> <offered square|-> <requested square|-> <offered $> <requested $>
+//   STATE <game>  -> OK <current> <money:position:inJail:bankrupt>... <owners>
+//   END <game>    -> OK
+//   QUIT          -> closes the connection
+// Each game's turn is suspended on a decision between commands. ROLL
+// answers a roll; the turn then runs until it needs another decision,
+// replied as ASK BUY <square>, ASK JAIL (1=pay, 2=card, 3=roll) or ASK ROLL
+// after doubles, which ANSWER (or ROLL) supplies. OK means the turn is over.
+// BUILD and the rest act for the current player while it is waiting to
+// roll. TRADE executes a trade both players have agreed to.
+const int DEFAULT_SERVER_THREADS = 4;
+const int DEFAULT_SERVER_GAMES = 4096;
+const int MAX_COMMAND_LENGTH = 256;
+
+// Function declarations
+int runServer(const char*, int, int);
+
+#endif
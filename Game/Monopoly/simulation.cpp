@@ -0,0 +1,243 @@
+#include "simulation.h"
+#include "turn.h"
+#include "profile.h"
+
+// Cash the basic bot keeps back when buying, building or paying
+const int BOT_CASH_RESERVE = 200;
+
+// Upper bound on pre-roll actions so a controller can't stall a turn
+const int MAX_TURN_ACTIONS = MAX_BOARD_SIZE * HOTEL;
+
+// Basic Bot Functions
+static bool basicWantsToBuy(const GameState* game, const Property board[], int propertyIndex, void* context) {
+    return game->players[game->currentPlayer].money - board[propertyIndex].price >= BOT_CASH_RESERVE;
+}
+
+static int basicChooseJailOption(const GameState* game, const Property board[], void* context) {
+    const Player* player = &game->players[game->currentPlayer];
+    
+    if (player->getOutOfJailCards > 0) {
+        return 2;
+    }
+    if (player->money >= game->board->jailFine + BOT_CASH_RESERVE) {
+        return 1;
+    }
+    return 3;
+}
+
+static int basicChooseBuild(const GameState* game, const Property board[], void* context) {
+    const Player* player = &game->players[game->currentPlayer];
+    
+    for (int i = 0; i < player->propertyCount; i++) {
+        int propertyIndex = player->ownedProperties[i];
+        if (canBuildHouse(game, board, propertyIndex) &&
+            player->money - board[propertyIndex].houseCost >= BOT_CASH_RESERVE) {
+            return propertyIndex;
+        }
+    }
+    return -1;
+}
+
+static int basicChooseMortgage(const GameState* game, const Property board[], void* context) {
+    return -1; // handleBankruptcy raises cash when it is actually needed
+}
+
+static int basicChooseUnmortgage(const GameState* game, const Property board[], void* context) {
+    const Player* player = &game->players[game->currentPlayer];
+    
+    for (int i = 0; i < player->propertyCount; i++) {
+        int propertyIndex = player->ownedProperties[i];
+        if (game->squares[propertyIndex].mortgaged &&
+            player->money - board[propertyIndex].price >= BOT_CASH_RESERVE) {
+            return propertyIndex;
+        }
+    }
+    return -1;
+}
+
+static bool basicProposeTrade(const GameState* game, const Property board[], TradeOffer* offer, void* context) {
+    return false;
+}
+
+static bool basicAcceptTrade(const GameState* game, const Property board[], const TradeOffer* offer, void* context) {
+    return false;
+}
+
+PlayerController BASIC_BOT = {
+    basicWantsToBuy,
+    basicChooseJailOption,
+    basicChooseBuild,
+    basicChooseMortgage,
+    basicChooseUnmortgage,
+    basicProposeTrade,
+    basicAcceptTrade,
+    0
+};
+
+// Shared by every headless game
+const PlayerNames BOT_NAMES = {{"Bot 1", "Bot 2", "Bot 3", "Bot 4"}};
+
+// Headless Engine Functions
+void setupHeadlessGame(GameState* game, const Board* board, int numPlayers, PlayerController* controller,
+                       unsigned long long seed) {
+    DiceRng rng;
+    seedDiceRng(&rng, seed);
+    setupHeadlessGameWithDice(game, board, numPlayers, controller, &rng);
+}
+
+// As setupHeadlessGame, with the dice (and the deck shuffles) drawn from
+// rng, such as one of a run's numbered streams
+void setupHeadlessGameWithDice(GameState* game, const Board* board, int numPlayers, PlayerController* controller,
+                               const DiceRng* rng) {
+    initializeBoard(game, board);
+    
+    game->names = &BOT_NAMES;
+    game->numPlayers = numPlayers;
+    for (int i = 0; i < numPlayers; i++) {
+        initializePlayer(&game->players[i], board->startingMoney);
+        game->controllers[i] = controller;
+    }
+    
+    game->currentPlayer = 0;
+    game->gameOver = false;
+    game->outputLevel = OUTPUT_SILENT;
+    game->journal = 0;
+    game->undo = 0;
+    game->replay = 0;
+    game->stats = 0;
+    startTurn(game);
+    game->dice.rng = *rng;
+    game->dice.next = DICE_BUFFER_SIZE; // First roll fills the buffer
+    initializeCards(game);
+    rebuildOwnershipIndex(game, game->board->squares);
+}
+
+// Pre-roll actions: trade, then unmortgage, mortgage and build
+static void playControllerActions(GameState* game, const Property board[]) {
+    PlayerController* controller = game->controllers[game->currentPlayer];
+    void* context = controller->context;
+    
+    TradeOffer offer;
+    if (controller->proposeTrade(game, board, &offer, context)) {
+        PlayerController* other = game->controllers[offer.toPlayer];
+        if (offer.fromPlayer == game->currentPlayer &&
+            other->acceptTrade(game, board, &offer, other->context)) {
+            executeTrade(game, board, &offer);
+        }
+    }
+    
+    int propertyIndex;
+    for (int i = 0; i < MAX_TURN_ACTIONS &&
+         (propertyIndex = controller->chooseUnmortgage(game, board, context)) != -1; i++) {
+        unmortgageProperty(game, board, propertyIndex);
+    }
+    for (int i = 0; i < MAX_TURN_ACTIONS &&
+         (propertyIndex = controller->chooseMortgage(game, board, context)) != -1; i++) {
+        mortgageProperty(game, board, propertyIndex);
+    }
+    for (int i = 0; i < MAX_TURN_ACTIONS &&
+         (propertyIndex = controller->chooseBuild(game, board, context)) != -1; i++) {
+        buildHouse(game, board, propertyIndex);
+    }
+}
+
+// One complete turn for the current player, driven by its controller
+void playTurn(GameState* game, const Property board[]) {
+    PROFILE_SCOPE(PROFILE_PLAY_TURN);
+    int decision = runTurn(game, board);
+    while (decision != DECISION_NONE) {
+        if (decision == DECISION_ROLL && game->turn.rolls == 0) {
+            playControllerActions(game, board);
+        }
+        decision = resumeTurn(game, board, controllerAnswer(game, board, decision));
+    }
+}
+
+static bool anyBankrupt(const GameState* game) {
+    for (int i = 0; i < game->numPlayers; i++) {
+        if (game->players[i].bankrupt) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Money plus what the player's properties and buildings cost
+int netWorth(const GameState* game, const Property board[], int playerNum) {
+    const Player* player = &game->players[playerNum];
+    int worth = player->money;
+    
+    for (int i = 0; i < player->propertyCount; i++) {
+        int propertyIndex = player->ownedProperties[i];
+        const SquareState* square = &game->squares[propertyIndex];
+        worth += square->mortgaged ? board[propertyIndex].mortgageValue : board[propertyIndex].price;
+        worth += square->houses * board[propertyIndex].houseCost;
+    }
+    return worth;
+}
+
+// Plays from the current state until someone wins or turnLimit is reached
+GameResult playGame(GameState* game, const Property board[], int turnLimit) {
+    GameResult result;
+    result.winner = -1;
+    result.turns = 0;
+    result.firstBankruptcy = -1;
+    
+    while (!game->gameOver && result.turns < turnLimit) {
+        playTurn(game, board);
+        result.turns++;
+        
+        if (result.firstBankruptcy == -1 && anyBankrupt(game)) {
+            result.firstBankruptcy = result.turns;
+        }
+        if (checkWinCondition(game)) {
+            game->gameOver = true;
+        }
+    }
+    
+    if (game->gameOver) {
+        for (int i = 0; i < game->numPlayers; i++) {
+            if (!game->players[i].bankrupt) {
+                result.winner = i;
+            }
+        }
+    }
+    return result;
+}
+
+void runSimulation(int numGames, int outputLevel) {
+    GameState game;
+    int wins[MAX_PLAYERS] = {0};
+    int unfinished = 0;
+    long long totalTurns = 0;
+    
+    unsigned long long seed = static_cast<unsigned long long>(time(0));
+    
+    clock_t start = clock();
+    for (int i = 0; i < numGames; i++) {
+        setupHeadlessGame(&game, activeBoard, MAX_PLAYERS, &BASIC_BOT, seed + i);
+        game.outputLevel = outputLevel;
+        GameResult result = playGame(&game, game.board->squares, DEFAULT_TURN_LIMIT);
+        
+        totalTurns += result.turns;
+        if (result.winner == -1) {
+            unfinished++;
+        } else {
+            wins[result.winner]++;
+        }
+    }
+    double seconds = static_cast<double>(clock() - start) / CLOCKS_PER_SEC;
+    
+    cout << "Simulated " << numGames << " games in " << seconds << "s";
+    if (seconds > 0) {
+        cout << " (" << static_cast<long long>(numGames / seconds) << " games/sec)";
+    }
+    cout << "\n";
+    for (int i = 0; i < MAX_PLAYERS; i++) {
+        cout << "Seat " << (i + 1) << " wins: " << wins[i] << "\n";
+    }
+    cout << "Unfinished (turn limit): " << unfinished << "\n";
+    if (numGames > 0) {
+        cout << "Average turns: " << (totalTurns / numGames) << "\n";
+    }
+}
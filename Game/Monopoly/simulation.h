@@ -0,0 +1,26 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include "monopoly.h"
+
+// Headless games stop after this many turns if nobody has won
+const int DEFAULT_TURN_LIMIT = 1000;
+
+struct GameResult {
+    int winner; // -1 if the turn limit was reached
+    int turns;
+    int firstBankruptcy; // turn the first player went bankrupt, -1 if nobody did
+};
+
+// Built-in bot: buys and builds while keeping a cash reserve
+extern PlayerController BASIC_BOT;
+
+// Function declarations
+void setupHeadlessGame(GameState*, const Board*, int, PlayerController*, unsigned long long);
+void setupHeadlessGameWithDice(GameState*, const Board*, int, PlayerController*, const DiceRng*);
+void playTurn(GameState*, const Property[]);
+GameResult playGame(GameState*, const Property[], int);
+int netWorth(const GameState*, const Property[], int);
+void runSimulation(int, int);
+
+#endif
@@ -0,0 +1,167 @@
+#include "stats.h"
+
+// Standard color group names; other boards use the same numbering
+const char* const COLOR_NAMES[NUM_COLORS] = {
+    "Brown", "Light Blue", "Pink", "Orange", "Red", "Yellow", "Green", "Dark Blue"
+};
+
+void clearStats(Stats* stats) {
+    memset(stats, 0, sizeof(Stats));
+}
+
+// Called by emitEvent for every event of a game with stats attached
+void recordStats(const GameState* game, const GameEvent* event) {
+    Stats* stats = game->stats;
+    
+    switch (event->type) {
+        case EVENT_LAND:
+        case EVENT_CARD_MOVE:
+            stats->landings[event->square]++;
+            break;
+        case EVENT_RENT:
+            stats->rent[event->square] += event->amount;
+            stats->rentPaid += event->amount;
+            addSample(&stats->rentPayment, event->amount);
+            break;
+        case EVENT_PASS_GO:
+            stats->salary += game->board->goSalary;
+            break;
+        case EVENT_TAX:
+            stats->taxes += event->amount;
+            break;
+        case EVENT_CARD_MONEY:
+            stats->cardMoney += event->amount;
+            break;
+        case EVENT_SENT_TO_JAIL:
+            stats->jailEntries++;
+            break;
+        case EVENT_LEFT_JAIL:
+            addSample(&stats->jailStay, event->amount);
+            if (event->value == JAIL_EXIT_FINE || event->value == JAIL_EXIT_THIRD_TURN) {
+                stats->jailFines += game->board->jailFine;
+            }
+            break;
+        case EVENT_BANKRUPT:
+            stats->bankruptcies++;
+            break;
+    }
+}
+
+void recordGameStats(Stats* stats, const GameResult* result) {
+    stats->games++;
+    addSample(&stats->gameLength, result->turns);
+}
+
+void mergeHistogram(Histogram* into, const Histogram* from) {
+    for (int i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        into->counts[i] += from->counts[i];
+    }
+    into->samples += from->samples;
+    into->sum += from->sum;
+    if (from->max > into->max) {
+        into->max = from->max;
+    }
+}
+
+// Adds one worker's counts into another's
+void mergeStats(Stats* into, const Stats* from) {
+    into->games += from->games;
+    for (int i = 0; i < MAX_BOARD_SIZE; i++) {
+        into->landings[i] += from->landings[i];
+        into->rent[i] += from->rent[i];
+    }
+    into->rentPaid += from->rentPaid;
+    into->salary += from->salary;
+    into->taxes += from->taxes;
+    into->jailFines += from->jailFines;
+    into->cardMoney += from->cardMoney;
+    into->jailEntries += from->jailEntries;
+    into->bankruptcies += from->bankruptcies;
+    mergeHistogram(&into->gameLength, &from->gameLength);
+    mergeHistogram(&into->jailStay, &from->jailStay);
+    mergeHistogram(&into->rentPayment, &from->rentPayment);
+}
+
+// Smallest value a bucket holds
+static int bucketLow(int bucket) {
+    if (bucket < HISTOGRAM_EXACT) {
+        return bucket;
+    }
+    int exponent = (bucket - HISTOGRAM_EXACT) / HISTOGRAM_STEPS + 4;
+    int step = (bucket - HISTOGRAM_EXACT) % HISTOGRAM_STEPS;
+    return (HISTOGRAM_STEPS + step) << (exponent - HISTOGRAM_STEP_BITS);
+}
+
+// The value at or below which fraction of the samples fall, to bucket
+// precision (the top of its bucket, but never above the largest sample)
+int histogramPercentile(const Histogram* histogram, double fraction) {
+    long long wanted = static_cast<long long>(fraction * histogram->samples);
+    long long seen = 0;
+    for (int i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        seen += histogram->counts[i];
+        if (seen > wanted) {
+            if (i + 1 < HISTOGRAM_BUCKETS && bucketLow(i + 1) - 1 < histogram->max) {
+                return bucketLow(i + 1) - 1;
+            }
+            return histogram->max;
+        }
+    }
+    return histogram->max;
+}
+
+static void displayHistogram(const char* label, const Histogram* histogram) {
+    cout << label << ": ";
+    if (histogram->samples == 0) {
+        cout << "none\n";
+        return;
+    }
+    cout << "mean " << static_cast<double>(histogram->sum) / histogram->samples
+         << ", median " << histogramPercentile(histogram, 0.5)
+         << ", 90% " << histogramPercentile(histogram, 0.9)
+         << ", 99% " << histogramPercentile(histogram, 0.99)
+         << ", max " << histogram->max << '\n';
+}
+
+void displayStats(const Stats* stats, const Board* board) {
+    double games = stats->games > 0 ? static_cast<double>(stats->games) : 1.0;
+    long long totalLandings = 0;
+    for (int i = 0; i < board->size; i++) {
+        totalLandings += stats->landings[i];
+    }
+    
+    cout << "\n=== Statistics (" << stats->games << " games) ===\n";
+    cout << fixed << setprecision(1);
+    displayHistogram("Game length (turns)", &stats->gameLength);
+    displayHistogram("Jail stay (turns)", &stats->jailStay);
+    displayHistogram("Rent payment ($)", &stats->rentPayment);
+    cout << "Per game: " << stats->jailEntries / games << " sent to jail, "
+         << stats->bankruptcies / games << " bankruptcies\n";
+    cout << "Money per game: rent $" << stats->rentPaid / games << ", salary $" << stats->salary / games
+         << ", taxes $" << stats->taxes / games << ", jail fines $" << stats->jailFines / games
+         << ", cards $" << stats->cardMoney / games << '\n';
+         
+    cout << "\n    " << left << setw(25) << "Square" << right << setw(9) << "Landed" << setw(14) << "Rent/game\n";
+    for (int i = 0; i < board->size; i++) {
+        double share = totalLandings > 0 ? 100.0 * stats->landings[i] / totalLandings : 0.0;
+        cout << setw(2) << i << ". " << left << setw(25) << board->squares[i].name << right
+             << setw(8) << share << '%' << setw(13) << stats->rent[i] / games << '\n';
+    }
+    
+    cout << "\n    " << left << setw(25) << "Color group" << right << setw(9) << "Share" << setw(14) << "Rent/game\n";
+    for (int color = 0; color < NUM_COLORS; color++) {
+        if (board->colorMasks[color] == 0) {
+            continue;
+        }
+        long long rent = 0;
+        for (int i = 0; i < board->size; i++) {
+            if (board->colorMasks[color] & squareBit(i)) {
+                rent += stats->rent[i];
+            }
+        }
+        double share = stats->rentPaid > 0 ? 100.0 * rent / stats->rentPaid : 0.0;
+        cout << "    " << left << setw(25) << COLOR_NAMES[color] << right
+             << setw(8) << share << '%' << setw(13) << rent / games << '\n';
+    }
+    cout.unsetf(ios::fixed);
+    cout << setprecision(6);
+}
@@ -0,0 +1,76 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include "events.h"
+#include "simulation.h"
+
+// Statistics are collected from game events (see emitEvent) into one Stats
+// per worker thread, so counting takes no locks or atomics, and merged
+// once the run is over.
+
+const int CACHE_LINE_SIZE = 64;
+
+// Log-bucketed histogram: values below HISTOGRAM_EXACT get a bucket each,
+// larger ones HISTOGRAM_STEPS buckets per power of two, so any value is
+// known to within 1/8 of itself
+const int HISTOGRAM_EXACT = 16;
+const int HISTOGRAM_STEP_BITS = 3;
+const int HISTOGRAM_STEPS = 1 << HISTOGRAM_STEP_BITS;
+const int HISTOGRAM_BUCKETS = HISTOGRAM_EXACT + (31 - 4) * HISTOGRAM_STEPS;
+
+struct Histogram {
+    long long counts[HISTOGRAM_BUCKETS];
+    long long samples;
+    long long sum;
+    int max;
+};
+
+// Padded to whole cache lines so workers writing neighbouring Stats never
+// share one
+struct alignas(CACHE_LINE_SIZE) Stats {
+    long long games;
+    long long landings[MAX_BOARD_SIZE];
+    long long rent[MAX_BOARD_SIZE]; // rent paid on each square
+    
+    // Money flow, totalled over all players
+    long long rentPaid;
+    long long salary;    // passing GO
+    long long taxes;
+    long long jailFines;
+    long long cardMoney; // net money cards gave the players who drew them
+    
+    long long jailEntries;
+    long long bankruptcies;
+    
+    Histogram gameLength;  // turns per game
+    Histogram jailStay;    // turns per stay in jail
+    Histogram rentPayment; // dollars per rent payment
+};
+
+inline int histogramBucket(int value) {
+    if (value < HISTOGRAM_EXACT) {
+        return value < 0 ? 0 : value;
+    }
+    int exponent = 31 - __builtin_clz(value);
+    int step = (value >> (exponent - HISTOGRAM_STEP_BITS)) & (HISTOGRAM_STEPS - 1);
+    return HISTOGRAM_EXACT + (exponent - 4) * HISTOGRAM_STEPS + step;
+}
+
+inline void addSample(Histogram* histogram, int value) {
+    histogram->counts[histogramBucket(value)]++;
+    histogram->samples++;
+    histogram->sum += value;
+    if (value > histogram->max) {
+        histogram->max = value;
+    }
+}
+
+// Function declarations
+void clearStats(Stats*);
+void recordGameStats(Stats*, const GameResult*);
+void mergeHistogram(Histogram*, const Histogram*);
+void mergeStats(Stats*, const Stats*);
+int histogramPercentile(const Histogram*, double);
+void displayStats(const Stats*, const Board*);
+
+#endif
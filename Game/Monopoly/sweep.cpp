@@ -0,0 +1,206 @@
+#include "sweep.h"
+#include <vector>
+#include <chrono>
+
+struct SweepColumn {
+    const char* name;
+    int type;
+    vector<unsigned long long> values; // doubles stored as their bits
+};
+
+// Result columns, after the rule parameters
+const SweepColumn RESULT_COLUMNS[] = {
+    {"games", SWEEP_INT, {}},
+    {"win_seat1", SWEEP_DOUBLE, {}},
+    {"win_seat2", SWEEP_DOUBLE, {}},
+    {"win_seat3", SWEEP_DOUBLE, {}},
+    {"win_seat4", SWEEP_DOUBLE, {}},
+    {"unfinished", SWEEP_DOUBLE, {}},
+    {"mean_turns", SWEEP_DOUBLE, {}},
+    {"bankrupt_games", SWEEP_INT, {}},
+    {"mean_bankruptcy_turn", SWEEP_DOUBLE, {}}
+};
+
+// Unswept parameters take the board's own value: 100% for the percentages
+void initializeSweepGrid(SweepGrid* grid, const Board* board) {
+    int defaults[NUM_SWEEP_PARAMETERS] = {board->startingMoney, board->goSalary, board->jailFine, 100, 100};
+    for (int i = 0; i < NUM_SWEEP_PARAMETERS; i++) {
+        grid->counts[i] = 1;
+        grid->values[i][0] = defaults[i];
+    }
+}
+
+// Reads one "name=value,value,..." argument into the grid
+bool parseSweepParameter(SweepGrid* grid, const char* argument) {
+    const char* equals = strchr(argument, '=');
+    int parameter = 0;
+    while (parameter < NUM_SWEEP_PARAMETERS &&
+           (equals == 0 || strncmp(argument, SWEEP_PARAMETER_NAMES[parameter], equals - argument) != 0 ||
+            SWEEP_PARAMETER_NAMES[parameter][equals - argument] != '\0')) {
+        parameter++;
+    }
+    if (parameter == NUM_SWEEP_PARAMETERS) {
+        cout << "Unknown sweep parameter in \"" << argument << "\". Parameters are money, salary, fine, rent and tax.\n";
+        return false;
+    }
+    
+    int count = 0;
+    const char* text = equals + 1;
+    for (;;) {
+        char* end;
+        long value = strtol(text, &end, 10);
+        if (end == text || value < 0 || value > 1000000 || (*end != ',' && *end != '\0')) {
+            cout << "Sweep values must be whole numbers from 0 to 1000000: \"" << argument << "\"\n";
+            return false;
+        }
+        if (count == MAX_SWEEP_VALUES) {
+            cout << "At most " << MAX_SWEEP_VALUES << " values per sweep parameter.\n";
+            return false;
+        }
+        grid->values[parameter][count++] = static_cast<int>(value);
+        if (*end == '\0') {
+            break;
+        }
+        text = end + 1;
+    }
+    grid->counts[parameter] = count;
+    return true;
+}
+
+static int scaled(int amount, int percent) {
+    return static_cast<int>(static_cast<long long>(amount) * percent / 100);
+}
+
+// Makes variant a copy of board with one grid point's rules. Utility rent
+// is a multiple of the roll and isn't scaled.
+void applySweepRules(Board* variant, const Board* board, const int rules[]) {
+    *variant = *board;
+    variant->startingMoney = rules[SWEEP_STARTING_MONEY];
+    variant->goSalary = rules[SWEEP_GO_SALARY];
+    variant->jailFine = rules[SWEEP_JAIL_FINE];
+    
+    for (int i = 0; i < variant->size; i++) {
+        Property* property = &variant->squares[i];
+        int percent = rules[SWEEP_RENT_PERCENT];
+        if (property->type == 1) {
+            property->baseRent = scaled(property->baseRent, percent);
+            property->rentWithSet = scaled(property->rentWithSet, percent);
+            for (int j = 0; j < 4; j++) {
+                property->rentWithHouses[j] = scaled(property->rentWithHouses[j], percent);
+            }
+            property->rentWithHotel = scaled(property->rentWithHotel, percent);
+        } else if (property->type == 2) {
+            property->baseRent = scaled(property->baseRent, percent);
+        } else if (property->type == 6) {
+            property->price = scaled(property->price, rules[SWEEP_TAX_PERCENT]);
+        }
+    }
+}
+
+static void putBytes(vector<unsigned char>* buffer, unsigned long long value, int bytes) {
+    for (int i = 0; i < bytes; i++) {
+        buffer->push_back(static_cast<unsigned char>(value >> (8 * i)));
+    }
+}
+
+static unsigned long long doubleBits(double value) {
+    unsigned long long bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static bool writeSweepFile(const char* filename, const vector<SweepColumn>& columns, int rows) {
+    vector<unsigned char> buffer(SWEEP_MAGIC, SWEEP_MAGIC + 4);
+    putBytes(&buffer, SWEEP_VERSION, 2);
+    putBytes(&buffer, columns.size(), 2);
+    putBytes(&buffer, rows, 4);
+    for (const SweepColumn& column : columns) {
+        int nameLength = static_cast<int>(strlen(column.name));
+        putBytes(&buffer, nameLength, 1);
+        buffer.insert(buffer.end(), column.name, column.name + nameLength);
+        putBytes(&buffer, column.type, 1);
+        for (unsigned long long value : column.values) {
+            putBytes(&buffer, value, 8);
+        }
+    }
+    
+    ofstream outFile(filename, ios::binary | ios::trunc);
+    outFile.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+    outFile.close();
+    if (!outFile) {
+        cout << "Error writing " << filename << "!\n";
+        return false;
+    }
+    return true;
+}
+
+// Plays gamesPerPoint games at every grid point, each point spread over
+// numThreads workers, and writes the results to filename. Returns the
+// process exit code.
+int runSweep(const SweepGrid* grid, long long gamesPerPoint, int numThreads, unsigned long long seed,
+             const char* filename) {
+    vector<SweepColumn> columns;
+    for (int i = 0; i < NUM_SWEEP_PARAMETERS; i++) {
+        columns.push_back({SWEEP_PARAMETER_NAMES[i], SWEEP_INT, {}});
+    }
+    columns.insert(columns.end(), begin(RESULT_COLUMNS), end(RESULT_COLUMNS));
+    
+    int points = 1;
+    for (int i = 0; i < NUM_SWEEP_PARAMETERS; i++) {
+        points *= grid->counts[i];
+    }
+    cout << "Sweep: " << points << " rule sets x " << gamesPerPoint << " games (seed " << seed << ")\n";
+    cout << "money salary fine rent% tax% | seat 1-4 win% | unfinished% | mean turns | first bankruptcy\n";
+    
+    auto start = chrono::steady_clock::now();
+    Board variant;
+    for (int point = 0; point < points; point++) {
+        // Mixed-radix count over the grid, last parameter fastest
+        int rules[NUM_SWEEP_PARAMETERS];
+        int rest = point;
+        for (int i = NUM_SWEEP_PARAMETERS - 1; i >= 0; i--) {
+            rules[i] = grid->values[i][rest % grid->counts[i]];
+            rest /= grid->counts[i];
+        }
+        applySweepRules(&variant, activeBoard, rules);
+        TournamentResult result = runTournament(gamesPerPoint, numThreads, seed, &BASIC_BOT, &variant, 0);
+        
+        double games = result.games > 0 ? static_cast<double>(result.games) : 1.0;
+        double bankruptcyTurn = result.bankruptcies > 0 ?
+                                static_cast<double>(result.totalBankruptcyTurns) / result.bankruptcies : 0.0;
+        double outcomes[] = {
+            result.wins[0] / games, result.wins[1] / games, result.wins[2] / games, result.wins[3] / games,
+            result.unfinished / games, result.totalTurns / games
+        };
+        
+        int column = 0;
+        for (int i = 0; i < NUM_SWEEP_PARAMETERS; i++) {
+            columns[column++].values.push_back(rules[i]);
+        }
+        columns[column++].values.push_back(result.games);
+        for (double outcome : outcomes) {
+            columns[column++].values.push_back(doubleBits(outcome));
+        }
+        columns[column++].values.push_back(result.bankruptcies);
+        columns[column++].values.push_back(doubleBits(bankruptcyTurn));
+        
+        cout << fixed << setprecision(1);
+        for (int i = 0; i < NUM_SWEEP_PARAMETERS; i++) {
+            cout << rules[i] << ' ';
+        }
+        cout << '|';
+        for (int i = 0; i < MAX_PLAYERS; i++) {
+            cout << ' ' << outcomes[i] * 100.0;
+        }
+        cout << " | " << outcomes[4] * 100.0 << " | " << outcomes[5] << " | " << bankruptcyTurn << '\n';
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout.unsetf(ios::fixed);
+    cout << setprecision(6);
+    
+    if (!writeSweepFile(filename, columns, points)) {
+        return 1;
+    }
+    cout << "Sweep finished in " << seconds << "s; results written to " << filename << '\n';
+    return 0;
+}
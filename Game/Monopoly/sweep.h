@@ -0,0 +1,44 @@
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include "tournament.h"
+
+// A sweep plays a tournament at every point of a grid of rule values and
+// writes one row of results per point. Every point plays the same game
+// seeds, so differences between rows come from the rules, not the dice.
+
+// Rule parameters, in grid and column order
+const int SWEEP_STARTING_MONEY = 0;
+const int SWEEP_GO_SALARY = 1;
+const int SWEEP_JAIL_FINE = 2;
+const int SWEEP_RENT_PERCENT = 3; // every property and railroad rent
+const int SWEEP_TAX_PERCENT = 4;  // every tax square
+const int NUM_SWEEP_PARAMETERS = 5;
+const char* const SWEEP_PARAMETER_NAMES[NUM_SWEEP_PARAMETERS] = {"money", "salary", "fine", "rent", "tax"};
+const int MAX_SWEEP_VALUES = 16;
+
+struct SweepGrid {
+    int counts[NUM_SWEEP_PARAMETERS];
+    int values[NUM_SWEEP_PARAMETERS][MAX_SWEEP_VALUES];
+};
+
+// Results file (integers little-endian, doubles IEEE 754 little-endian):
+//   header:  magic "MSWP", version (2 bytes), column count (2 bytes),
+//            row count (4 bytes)
+//   columns: name length (1 byte), name, type (1 byte), then the column's
+//            value for every row, 8 bytes each
+// Columns are the five rule parameters, games, win_seat1-4, unfinished
+// (rates), mean_turns, bankrupt_games and mean_bankruptcy_turn (the turn
+// the first player went bankrupt, over the games where one did).
+const unsigned char SWEEP_MAGIC[4] = {'M', 'S', 'W', 'P'};
+const int SWEEP_VERSION = 1;
+const int SWEEP_INT = 0;    // signed 64-bit
+const int SWEEP_DOUBLE = 1;
+
+// Function declarations
+void initializeSweepGrid(SweepGrid*, const Board*);
+bool parseSweepParameter(SweepGrid*, const char*);
+void applySweepRules(Board*, const Board*, const int[]);
+int runSweep(const SweepGrid*, long long, int, unsigned long long, const char*);
+
+#endif
@@ -0,0 +1,195 @@
+#include "tournament.h"
+#include "stats.h"
+#include <thread>
+#include <mutex>
+#include <vector>
+#include <chrono>
+
+// Range of game numbers still to be played by one worker. Other workers
+// steal from the top of the range when their own runs dry.
+struct WorkQueue {
+    mutex lock;
+    long long next;
+    long long end;
+};
+
+struct WorkerContext {
+    vector<WorkQueue>* queues;
+    int id;
+    unsigned long long seed;
+    PlayerController* controller;
+    const Board* board;
+    Stats* stats; // this worker's own, or null
+    TournamentResult partial;
+};
+
+// Takes up to one batch from the worker's own queue
+static bool takeOwnWork(WorkQueue* queue, long long* first, long long* last) {
+    lock_guard<mutex> guard(queue->lock);
+    if (queue->next >= queue->end) {
+        return false;
+    }
+    *first = queue->next;
+    *last = min(queue->next + TOURNAMENT_BATCH_SIZE, queue->end);
+    queue->next = *last;
+    return true;
+}
+
+// Moves the top half of the fullest other queue into the worker's queue
+static bool stealWork(vector<WorkQueue>& queues, int id) {
+    int victim = -1;
+    long long mostLeft = 0;
+    
+    for (int i = 0; i < static_cast<int>(queues.size()); i++) {
+        if (i == id) continue;
+        lock_guard<mutex> guard(queues[i].lock);
+        if (queues[i].end - queues[i].next > mostLeft) {
+            mostLeft = queues[i].end - queues[i].next;
+            victim = i;
+        }
+    }
+    if (victim == -1) {
+        return false;
+    }
+    
+    long long first, last;
+    {
+        lock_guard<mutex> guard(queues[victim].lock);
+        long long left = queues[victim].end - queues[victim].next;
+        if (left <= 0) {
+            return true; // Someone else got there first; look again
+        }
+        first = queues[victim].next + left / 2;
+        last = queues[victim].end;
+        queues[victim].end = first;
+    }
+    
+    lock_guard<mutex> guard(queues[id].lock);
+    queues[id].next = first;
+    queues[id].end = last;
+    return true;
+}
+
+static void tournamentWorker(WorkerContext* context) {
+    // Each worker plays its own game state; the board itself is read-only
+    GameState game;
+    WorkQueue* own = &(*context->queues)[context->id];
+    long long first, last;
+    
+    // Game i plays on dice stream i of the tournament seed, so results
+    // don't depend on which thread played it
+    DiceStreams streams;
+    seedDiceStreams(&streams, context->seed);
+    DiceRng rng;
+    
+    for (;;) {
+        if (!takeOwnWork(own, &first, &last)) {
+            if (!stealWork(*context->queues, context->id)) {
+                break;
+            }
+            continue;
+        }
+        
+        for (long long i = first; i < last; i++) {
+            findDiceStream(&streams, i, &rng);
+            setupHeadlessGameWithDice(&game, context->board, MAX_PLAYERS, context->controller, &rng);
+            game.stats = context->stats;
+            GameResult result = playGame(&game, game.board->squares, DEFAULT_TURN_LIMIT);
+            if (context->stats) {
+                recordGameStats(context->stats, &result);
+            }
+            
+            context->partial.games++;
+            context->partial.totalTurns += result.turns;
+            if (result.firstBankruptcy != -1) {
+                context->partial.bankruptcies++;
+                context->partial.totalBankruptcyTurns += result.firstBankruptcy;
+            }
+            if (result.winner == -1) {
+                context->partial.unfinished++;
+            } else {
+                context->partial.wins[result.winner]++;
+            }
+        }
+    }
+}
+
+// Plays numGames independent headless games on board across numThreads
+// workers (0 = one per core). Totals are sums over games, so the merged
+// result is the same for a given seed whatever the thread count or
+// scheduling. If stats isn't null, statistics are collected per worker
+// and added to it at the end.
+TournamentResult runTournament(long long numGames, int numThreads, unsigned long long seed,
+                               PlayerController* controller, const Board* board, Stats* stats) {
+    if (numThreads <= 0) {
+        numThreads = static_cast<int>(thread::hardware_concurrency());
+        if (numThreads <= 0) numThreads = 1;
+    }
+    if (numGames < 0) numGames = 0;
+    
+    vector<WorkQueue> queues(numThreads);
+    vector<WorkerContext> contexts(numThreads);
+    vector<Stats> workerStats(stats ? numThreads : 0);
+    for (int i = 0; i < numThreads; i++) {
+        queues[i].next = numGames * i / numThreads;
+        queues[i].end = numGames * (i + 1) / numThreads;
+        
+        contexts[i].queues = &queues;
+        contexts[i].id = i;
+        contexts[i].seed = seed;
+        contexts[i].controller = controller;
+        contexts[i].board = board;
+        contexts[i].stats = 0;
+        if (stats) {
+            clearStats(&workerStats[i]);
+            contexts[i].stats = &workerStats[i];
+        }
+        memset(&contexts[i].partial, 0, sizeof(TournamentResult));
+    }
+    
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    vector<thread> workers;
+    for (int i = 0; i < numThreads; i++) {
+        workers.push_back(thread(tournamentWorker, &contexts[i]));
+    }
+    for (int i = 0; i < numThreads; i++) {
+        workers[i].join();
+    }
+    
+    // Merge in worker order
+    TournamentResult result;
+    memset(&result, 0, sizeof(TournamentResult));
+    for (int i = 0; i < numThreads; i++) {
+        result.games += contexts[i].partial.games;
+        result.unfinished += contexts[i].partial.unfinished;
+        result.totalTurns += contexts[i].partial.totalTurns;
+        result.bankruptcies += contexts[i].partial.bankruptcies;
+        result.totalBankruptcyTurns += contexts[i].partial.totalBankruptcyTurns;
+        for (int j = 0; j < MAX_PLAYERS; j++) {
+            result.wins[j] += contexts[i].partial.wins[j];
+        }
+        if (stats) {
+            mergeStats(stats, &workerStats[i]);
+        }
+    }
+    result.threads = numThreads;
+    result.seed = seed;
+    result.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+void displayTournamentResult(const TournamentResult* result) {
+    cout << "Tournament: " << result->games << " games on " << result->threads
+         << " threads (seed " << result->seed << ") in " << result->seconds << "s";
+    if (result->seconds > 0) {
+        cout << " (" << static_cast<long long>(result->games / result->seconds) << " games/sec)";
+    }
+    cout << "\n";
+    for (int i = 0; i < MAX_PLAYERS; i++) {
+        cout << "Seat " << (i + 1) << " wins: " << result->wins[i] << "\n";
+    }
+    cout << "Unfinished (turn limit): " << result->unfinished << "\n";
+    if (result->games > 0) {
+        cout << "Average turns: " << (result->totalTurns / result->games) << "\n";
+    }
+}
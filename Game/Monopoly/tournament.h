@@ -0,0 +1,25 @@
+#ifndef TOURNAMENT_H
+#define TOURNAMENT_H
+
+#include "simulation.h"
+
+// Games a worker takes from its own queue at a time
+const int TOURNAMENT_BATCH_SIZE = 64;
+
+struct TournamentResult {
+    long long games;
+    long long wins[MAX_PLAYERS];
+    long long unfinished;
+    long long totalTurns;
+    long long bankruptcies;         // games where somebody went bankrupt
+    long long totalBankruptcyTurns; // turn of the first bankruptcy, summed over those
+    int threads;
+    unsigned long long seed;
+    double seconds;
+};
+
+// Function declarations
+TournamentResult runTournament(long long, int, unsigned long long, PlayerController*, const Board*, Stats*);
+void displayTournamentResult(const TournamentResult*);
+
+#endif
@@ -0,0 +1,164 @@
+#include "turn.h"
+#include "journal.h"
+#include "replay.h"
+#include "events.h"
+
+// Turn phases. The AWAIT phases are where a turn stops for a decision;
+// the others run straight through.
+const int PHASE_START = 0;
+const int PHASE_AWAIT_ROLL = 1;
+const int PHASE_AWAIT_JAIL = 2;
+const int PHASE_AWAIT_BUY = 3;
+const int PHASE_LANDED = 4;
+const int PHASE_RESOLVED = 5;
+
+// Resets the turn state so the current player's turn starts from scratch
+void startTurn(GameState* game) {
+    TurnState* turn = &game->turn;
+    turn->phase = PHASE_START;
+    turn->decision = DECISION_NONE;
+    turn->square = 0;
+    turn->rolls = 0;
+    turn->dice1 = 0;
+    turn->dice2 = 0;
+    turn->fromJail = false;
+    turn->cardRent = 0;
+}
+
+// Ends the current turn, also used to abandon one early. A turn only
+// waits on DECISION_ROLL here if the player gave it up.
+void finishTurn(GameState* game) {
+    bool abandoned = game->turn.decision == DECISION_ROLL;
+    game->currentPlayer = (game->currentPlayer + 1) % game->numPlayers;
+    startTurn(game);
+    commitJournalTurn(game);
+    if (game->replay) {
+        commitReplayTurn(game, abandoned);
+    }
+}
+
+static int suspendTurn(GameState* game, int phase, int decision) {
+    game->turn.phase = phase;
+    game->turn.decision = decision;
+    return decision;
+}
+
+// Runs from the current phase to the next decision or the end of the turn.
+// answer is only read by the AWAIT phase the turn was suspended in.
+static int advanceTurn(GameState* game, const Property board[], int answer) {
+    Player* player = &game->players[game->currentPlayer];
+    TurnState* turn = &game->turn;
+    
+    while (true) {
+        switch (turn->phase) {
+            case PHASE_START:
+                if (player->bankrupt) {
+                    finishTurn(game);
+                    return DECISION_NONE;
+                }
+                return suspendTurn(game, PHASE_AWAIT_ROLL, DECISION_ROLL);
+                
+            case PHASE_AWAIT_ROLL: {
+                if (player->inJail) {
+                    return suspendTurn(game, PHASE_AWAIT_JAIL, DECISION_JAIL);
+                }
+                int dice1, dice2;
+                rollDice(game, &dice1, &dice2);
+                emitEvent(game, EVENT_ROLL, game->currentPlayer, 0, dice1, dice2);
+                turn->rolls++;
+                turn->dice1 = dice1;
+                turn->dice2 = dice2;
+                turn->fromJail = false;
+                movePlayer(game, board, dice1 + dice2);
+                turn->phase = PHASE_LANDED;
+                break;
+            }
+            
+            case PHASE_AWAIT_JAIL: {
+                int steps = handleJailTurn(game, board, answer);
+                turn->rolls++;
+                if (steps == 0) {
+                    finishTurn(game);
+                    return DECISION_NONE;
+                }
+                // Leaving jail never earns another roll
+                turn->dice1 = steps;
+                turn->dice2 = 0;
+                turn->fromJail = true;
+                movePlayer(game, board, steps);
+                turn->phase = PHASE_LANDED;
+                break;
+            }
+            
+            case PHASE_LANDED: {
+                bool forSale = handleProperty(game, board, turn->dice1 + turn->dice2);
+                turn->cardRent = 0;
+                if (forSale) {
+                    turn->square = player->position;
+                    return suspendTurn(game, PHASE_AWAIT_BUY, DECISION_BUY);
+                }
+                turn->phase = PHASE_RESOLVED;
+                break;
+            }
+                
+            case PHASE_AWAIT_BUY:
+                if (answer) {
+                    buyProperty(game, board, turn->square);
+                }
+                turn->phase = PHASE_RESOLVED;
+                break;
+                
+            case PHASE_RESOLVED:
+                // Squares reached straight out of jail only charge rent. A
+                // card that moves the player lands them again on the new square.
+                if (!turn->fromJail) {
+                    int square = player->position;
+                    handleSpecialSpace(game, board, square);
+                    if (player->position != square && !player->inJail) {
+                        turn->phase = PHASE_LANDED;
+                        break;
+                    }
+                }
+                if (player->money < 0) {
+                    handleBankruptcy(game, board);
+                } else if (!turn->fromJail && !player->inJail && isDouble(turn->dice1, turn->dice2)) {
+                    return suspendTurn(game, PHASE_AWAIT_ROLL, DECISION_ROLL);
+                }
+                finishTurn(game);
+                return DECISION_NONE;
+        }
+    }
+}
+
+// Starts the current player's turn and runs it to its first decision.
+// A turn that is already waiting just returns its decision again.
+int runTurn(GameState* game, const Property board[]) {
+    if (game->turn.decision != DECISION_NONE) {
+        return game->turn.decision;
+    }
+    return advanceTurn(game, board, 0);
+}
+
+// Answers the decision the turn is waiting on and runs it to the next one.
+// No decision is pending while the turn runs, which is how the replay
+// tells players' actions apart from the engine's own (see replay.h).
+int resumeTurn(GameState* game, const Property board[], int answer) {
+    if (game->replay) {
+        recordReplayAnswer(game, answer);
+    }
+    game->turn.decision = DECISION_NONE;
+    return advanceTurn(game, board, answer);
+}
+
+// Asks the current player's controller to answer a decision
+int controllerAnswer(GameState* game, const Property board[], int decision) {
+    PlayerController* controller = game->controllers[game->currentPlayer];
+    
+    switch (decision) {
+        case DECISION_BUY:
+            return controller->wantsToBuy(game, board, game->turn.square, controller->context);
+        case DECISION_JAIL:
+            return controller->chooseJailOption(game, board, controller->context);
+    }
+    return 0; // DECISION_ROLL needs no answer
+}
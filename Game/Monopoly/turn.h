@@ -0,0 +1,27 @@
+#ifndef TURN_H
+#define TURN_H
+
+#include "monopoly.h"
+
+// A turn is an explicit state machine kept in GameState::turn. It runs
+// until a player decision is needed, records where it stopped and returns
+// the decision; the caller resumes it later with the answer. Nothing in
+// here blocks, so one thread can keep any number of games in flight, and
+// console, bot and server players are just different drivers.
+//
+//   int decision = runTurn(game, board);
+//   while (decision != DECISION_NONE) {
+//       decision = resumeTurn(game, board, answerFor(decision));
+//   }
+//
+// While a turn waits on DECISION_ROLL the player may trade, build, sell
+// and (un)mortgage through the usual engine functions before answering.
+
+// Function declarations
+void startTurn(GameState*);
+int runTurn(GameState*, const Property[]);
+int resumeTurn(GameState*, const Property[], int);
+void finishTurn(GameState*);
+int controllerAnswer(GameState*, const Property[], int);
+
+#endif
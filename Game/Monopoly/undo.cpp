@@ -0,0 +1,232 @@
+#include "undo.h"
+
+// Starts recording; the log's copies of positions, jail state and the
+// dice generator are taken from the game as it is now
+void attachUndoLog(GameState* game, UndoLog* log) {
+    log->length = 0;
+    log->refillCount = 0;
+    log->overflowed = false;
+    for (int i = 0; i < game->numPlayers; i++) {
+        const Player* player = &game->players[i];
+        log->positions[i] = player->position;
+        log->inJail[i] = player->inJail;
+        log->jailTurns[i] = player->jailTurns;
+        log->jailCards[i] = player->getOutOfJailCards;
+    }
+    for (int i = 0; i < game->board->size; i++) {
+        log->houses[i] = game->squares[i].houses;
+    }
+    log->rng = game->dice.rng;
+    game->undo = log;
+}
+
+void detachUndoLog(GameState* game) {
+    game->undo = 0;
+}
+
+UndoMark markUndo(const GameState* game) {
+    UndoMark mark;
+    mark.length = game->undo->length;
+    mark.refillCount = game->undo->refillCount;
+    mark.currentPlayer = game->currentPlayer;
+    mark.gameOver = game->gameOver;
+    mark.turn = game->turn;
+    return mark;
+}
+
+static void pushUndo(UndoLog* log, int type, int player, int square, int value, int amount) {
+    JournalRecord* entry = &log->entries[log->length++];
+    entry->type = static_cast<unsigned char>(type);
+    entry->player = static_cast<unsigned char>(player);
+    entry->square = static_cast<unsigned char>(square);
+    entry->value = static_cast<unsigned char>(value);
+    entry->amount = amount;
+}
+
+// Called by journalEvent for every change made while a log is attached.
+// Trades and bankruptcies are journaled before they change anything, the
+// rest after.
+void recordUndo(GameState* game, const JournalRecord* record) {
+    UndoLog* log = game->undo;
+    int playerNum = record->player;
+    
+    // Room for the largest case, a bankruptcy giving back every square
+    if (log->overflowed || log->length + MAX_BOARD_SIZE + 1 > UNDO_LOG_SIZE) {
+        log->overflowed = true;
+        return;
+    }
+    
+    switch (record->type) {
+        case JOURNAL_ROLL:
+            if (memcmp(&log->rng, &game->dice.rng, sizeof(DiceRng)) != 0) {
+                if (log->refillCount == UNDO_MAX_REFILLS) {
+                    log->overflowed = true;
+                    return;
+                }
+                log->refills[log->refillCount] = log->rng;
+                pushUndo(log, UNDO_REFILL, 0, 0, 0, log->refillCount++);
+                log->rng = game->dice.rng;
+            }
+            log->entries[log->length++] = *record;
+            return;
+            
+        case JOURNAL_MOVE:
+            pushUndo(log, JOURNAL_MOVE, playerNum, record->square, log->positions[playerNum], record->amount);
+            log->positions[playerNum] = record->square;
+            return;
+            
+        case JOURNAL_JAIL:
+            pushUndo(log, JOURNAL_JAIL, playerNum, log->inJail[playerNum], log->jailTurns[playerNum],
+                     log->jailCards[playerNum]);
+            log->inJail[playerNum] = record->square != 0;
+            log->jailTurns[playerNum] = record->value;
+            log->jailCards[playerNum] = static_cast<unsigned char>(record->amount);
+            return;
+            
+        case JOURNAL_BUILD:
+            pushUndo(log, JOURNAL_BUILD, playerNum, record->square, log->houses[record->square], record->amount);
+            log->houses[record->square] = record->value;
+            return;
+            
+        case JOURNAL_BANKRUPT: {
+            // Last holding first, so undoing re-appends them in list order
+            const Player* player = &game->players[playerNum];
+            for (int i = player->propertyCount - 1; i >= 0; i--) {
+                int propertyIndex = player->ownedProperties[i];
+                const SquareState* square = &game->squares[propertyIndex];
+                pushUndo(log, UNDO_SQUARE, playerNum, propertyIndex,
+                         square->houses | (square->mortgaged ? 0x80 : 0), 0);
+                log->houses[propertyIndex] = 0;
+            }
+            pushUndo(log, JOURNAL_BANKRUPT, playerNum, 0, 0, 0);
+            return;
+        }
+            
+        case JOURNAL_TURN:
+            return; // undoTo restores turn progress from the mark
+    }
+    log->entries[log->length++] = *record;
+}
+
+// Moves the last holding of one player back into slot of another. The
+// square lands at the end of the list and swaps places with whatever
+// setPropertyOwner moved into its slot when it left.
+static void returnHolding(GameState* game, const Property board[], int fromPlayer, int toPlayer, int slot) {
+    const Player* from = &game->players[fromPlayer];
+    Player* to = &game->players[toPlayer];
+    int propertyIndex = from->ownedProperties[from->propertyCount - 1];
+    setPropertyOwner(game, board, propertyIndex, toPlayer);
+    
+    int last = to->propertyCount - 1;
+    int moved = to->ownedProperties[slot];
+    to->ownedProperties[last] = moved;
+    to->ownedProperties[slot] = propertyIndex;
+    game->squares[moved].slot = last;
+    game->squares[propertyIndex].slot = slot;
+}
+
+static void revertEntry(GameState* game, const Property board[], UndoLog* log, const JournalRecord* entry) {
+    int playerNum = entry->player;
+    Player* player = &game->players[playerNum & 0x0F];
+    
+    switch (entry->type) {
+        case JOURNAL_ROLL:
+            game->dice.pairs[--game->dice.next] = entry->value;
+            break;
+            
+        case UNDO_REFILL:
+            game->dice.rng = log->refills[entry->amount];
+            game->dice.next = DICE_BUFFER_SIZE;
+            log->rng = game->dice.rng;
+            break;
+            
+        case JOURNAL_MOVE:
+            player->money -= entry->amount;
+            player->position = entry->value;
+            log->positions[playerNum] = entry->value;
+            break;
+            
+        case JOURNAL_PAYMENT:
+            player->money -= entry->amount;
+            break;
+            
+        case JOURNAL_PURCHASE:
+            player->money += entry->amount;
+            setPropertyOwner(game, board, entry->square, -1);
+            break;
+            
+        case JOURNAL_RENT:
+            player->money += entry->amount;
+            game->players[entry->value].money -= entry->amount;
+            break;
+            
+        case JOURNAL_CARD:
+            game->deckIndex[entry->square] = entry->value;
+            break;
+            
+        case JOURNAL_JAIL:
+            player->inJail = entry->square != 0;
+            player->jailTurns = entry->value;
+            player->getOutOfJailCards = static_cast<unsigned char>(entry->amount);
+            log->inJail[playerNum] = player->inJail;
+            log->jailTurns[playerNum] = player->jailTurns;
+            log->jailCards[playerNum] = player->getOutOfJailCards;
+            break;
+            
+        case JOURNAL_BUILD:
+            setHouses(game, entry->square, entry->value);
+            log->houses[entry->square] = entry->value;
+            player->money -= entry->amount;
+            break;
+            
+        case JOURNAL_MORTGAGE:
+            setMortgaged(game, entry->square, entry->value == 0);
+            player->money -= entry->amount;
+            break;
+            
+        case JOURNAL_TRADE: {
+            // executeTrade appends each received square, so take the
+            // requested one back first
+            int fromPlayer = playerNum & 0x0F;
+            int toPlayer = playerNum >> 4;
+            if (entry->value != 0xFF) {
+                returnHolding(game, board, fromPlayer, toPlayer, entry->value);
+            }
+            if (entry->square != 0xFF) {
+                returnHolding(game, board, toPlayer, fromPlayer, entry->square);
+            }
+            game->players[fromPlayer].money += entry->amount;
+            game->players[toPlayer].money -= entry->amount;
+            break;
+        }
+            
+        case JOURNAL_BANKRUPT:
+            player->bankrupt = false;
+            break;
+            
+        case UNDO_SQUARE:
+            setPropertyOwner(game, board, entry->square, playerNum);
+            setHouses(game, entry->square, entry->value & 0x7F);
+            setMortgaged(game, entry->square, (entry->value & 0x80) != 0);
+            log->houses[entry->square] = entry->value & 0x7F;
+            break;
+    }
+}
+
+// Reverts every change since the mark. Returns false, leaving the game as
+// it is, if the log ran out of room since then.
+bool undoTo(GameState* game, const Property board[], const UndoMark* mark) {
+    UndoLog* log = game->undo;
+    if (log->overflowed) {
+        return false;
+    }
+    
+    while (log->length > mark->length) {
+        revertEntry(game, board, log, &log->entries[--log->length]);
+    }
+    log->refillCount = mark->refillCount;
+    game->currentPlayer = mark->currentPlayer;
+    game->gameOver = mark->gameOver;
+    game->turn = mark->turn;
+    return true;
+}
@@ -0,0 +1,62 @@
+#ifndef UNDO_H
+#define UNDO_H
+
+#include "journal.h"
+
+// Make/unmake for search. While an undo log is attached, every change the
+// engine journals (see journal.h) also leaves an undo entry, and undoTo()
+// reverts the entries in reverse order back to a mark. A search can then
+// explore moves in place, paying a few bytes per change instead of a
+// GameState copy per node:
+//
+//   UndoMark mark = markUndo(game);
+//   ... roll, answer decisions, build, trade ...
+//   undoTo(game, board, &mark);
+//
+// Entries are journal records. MOVE, JAIL and BUILD entries hold the values
+// from before the change rather than after (for BUILD, the houses the
+// square had, so undoing doesn't have to tell a build from a sale), and two undo-only types cover
+// what a journal replay can recompute but an undo can't.
+//
+// Searched games shouldn't have a journal, and while the log is attached
+// the dice must only be used through rollDice (no reseeding).
+const int UNDO_LOG_SIZE = 8192;
+const int UNDO_MAX_REFILLS = 256;
+
+// Undo-only entry types, numbered after the journal's
+const int UNDO_SQUARE = 14; // player = owner, square, value = houses | 0x80 if mortgaged
+const int UNDO_REFILL = 15; // the dice were refilled; amount = saved generator
+
+struct UndoLog {
+    JournalRecord entries[UNDO_LOG_SIZE];
+    int length;
+    DiceRng refills[UNDO_MAX_REFILLS]; // generators from before each refill
+    int refillCount;
+    bool overflowed;
+    
+    // State as of the last entry, for the fields whose journal records only
+    // say what they changed to
+    unsigned char positions[MAX_PLAYERS];
+    bool inJail[MAX_PLAYERS];
+    unsigned char jailTurns[MAX_PLAYERS];
+    unsigned char jailCards[MAX_PLAYERS];
+    unsigned char houses[MAX_BOARD_SIZE];
+    DiceRng rng;
+};
+
+// Where to undo back to. Turn progress isn't journaled, so the mark keeps it.
+struct UndoMark {
+    int length;
+    int refillCount;
+    int currentPlayer;
+    bool gameOver;
+    TurnState turn;
+};
+
+// Function declarations
+void attachUndoLog(GameState*, UndoLog*);
+void detachUndoLog(GameState*);
+UndoMark markUndo(const GameState*);
+bool undoTo(GameState*, const Property[], const UndoMark*);
+
+#endif
@@ -0,0 +1,171 @@
+#include "whatif.h"
+#include "fork.h"
+#include "savefile.h"
+#include <thread>
+#include <vector>
+#include <chrono>
+
+struct WhatIfWorker {
+    const GameFork* forks[WHATIF_ALTERNATIVES];
+    int turns;
+    long long first; // branches first to end - 1
+    long long end;
+    unsigned long long seed;
+    WhatIfResult partial;
+};
+
+static void whatIfWorker(WhatIfWorker* worker) {
+    GameState game;
+    
+    // Both alternatives of a branch roll dice stream branch of the seed
+    DiceStreams streams;
+    seedDiceStreams(&streams, worker->seed);
+    DiceRng rng;
+    for (long long branch = worker->first; branch < worker->end; branch++) {
+        findDiceStream(&streams, branch, &rng);
+        for (int alternative = 0; alternative < WHATIF_ALTERNATIVES; alternative++) {
+            restoreFork(worker->forks[alternative], &game);
+            game.dice.rng = rng;
+            game.dice.next = DICE_BUFFER_SIZE;
+            playGame(&game, game.board->squares, worker->turns);
+            
+            for (int i = 0; i < game.numPlayers; i++) {
+                worker->partial.netWorth[alternative][i] += netWorth(&game, game.board->squares, i);
+                if (game.players[i].bankrupt) {
+                    worker->partial.bankrupt[alternative][i]++;
+                }
+            }
+        }
+        worker->partial.branches++;
+    }
+}
+
+static void displayWhatIfResult(const WhatIfResult* result, const GameState* game, int playerNum, int square) {
+    double branches = result->branches > 0 ? static_cast<double>(result->branches) : 1.0;
+    cout << result->branches << " branches on " << result->threads << " threads in " << result->seconds << "s\n";
+    cout << "Alternatives: as saved, or " << playerName(game, playerNum) << " buys "
+         << game->board->squares[square].name << " for $" << game->board->squares[square].price << '\n';
+    cout << fixed << setprecision(1);
+    cout << '\n' << left << setw(20) << "Player" << right << setw(14) << "Worth saved" << setw(14) << "Worth buys"
+         << setw(12) << "Change" << setw(16) << "Bankrupt saved" << setw(15) << "Bankrupt buys" << '\n';
+    for (int i = 0; i < game->numPlayers; i++) {
+        double saved = result->netWorth[WHATIF_AS_SAVED][i] / branches;
+        double buys = result->netWorth[WHATIF_BUYS][i] / branches;
+        cout << left << setw(20) << playerName(game, i) << right << setw(14) << saved << setw(14) << buys
+             << setw(12) << buys - saved << setw(15) << 100.0 * result->bankrupt[WHATIF_AS_SAVED][i] / branches << '%'
+             << setw(14) << 100.0 * result->bankrupt[WHATIF_BUYS][i] / branches << "%\n";
+    }
+    cout.unsetf(ios::fixed);
+    cout << setprecision(6);
+    cout << "\nForks: as saved " << result->forkBytes[WHATIF_AS_SAVED] << " bytes, buys "
+         << result->forkBytes[WHATIF_BUYS] << " bytes on top of it (a GameState is " << sizeof(GameState) << ")\n";
+}
+
+// Loads filename and plays branches of turns turns from it both ways, for
+// player playerNum (0-based) buying square. Returns the process exit code.
+int runWhatIf(const char* filename, int playerNum, int square, int turns, long long branches,
+              int numThreads, unsigned long long seed) {
+    ifstream inFile(filename, ios::binary);
+    if (!inFile) {
+        cout << "Can't open " << filename << ".\n";
+        return 1;
+    }
+    unsigned char buffer[MAX_SAVE_SIZE + 1];
+    inFile.read(reinterpret_cast<char*>(buffer), sizeof(buffer));
+    int length = static_cast<int>(inFile.gcount());
+    inFile.close();
+    
+    static GameState game;
+    static PlayerNames names;
+    initializeBoard(&game, activeBoard);
+    int loaded = decodeGame(buffer, length, &game, &names);
+    if (loaded != SAVE_OK) {
+        cout << "The save file " << saveErrorMessage(loaded) << ".\n";
+        return 1;
+    }
+    game.names = &names;
+    game.outputLevel = OUTPUT_SILENT;
+    game.journal = 0;
+    game.undo = 0;
+    game.replay = 0;
+    game.stats = 0;
+    for (int i = 0; i < game.numPlayers; i++) {
+        game.controllers[i] = &BASIC_BOT;
+    }
+    rebuildOwnershipIndex(&game, game.board->squares);
+    
+    const Property* board = game.board->squares;
+    if (playerNum < 0 || playerNum >= game.numPlayers || game.players[playerNum].bankrupt) {
+        cout << "There is no player " << playerNum + 1 << " still in the game.\n";
+        return 1;
+    }
+    if (square < 0 || square >= game.board->size || board[square].type < 1 || board[square].type > 3 ||
+        game.squares[square].owner != -1) {
+        cout << "Square " << square << " isn't a property for sale.\n";
+        return 1;
+    }
+    if (game.players[playerNum].money < board[square].price) {
+        cout << playerName(&game, playerNum) << " can't afford " << board[square].name << ".\n";
+        return 1;
+    }
+    if (numThreads <= 0) {
+        numThreads = static_cast<int>(thread::hardware_concurrency());
+        if (numThreads <= 0) numThreads = 1;
+    }
+    if (branches < 0) branches = 0;
+    
+    // The purchase is made as if on the buyer's turn, then play goes on
+    // from whoever's turn it was
+    GameFork* forks[WHATIF_ALTERNATIVES];
+    forks[WHATIF_AS_SAVED] = forkGame(&game, 0);
+    static GameState buying;
+    buying = game;
+    buying.currentPlayer = playerNum;
+    buyProperty(&buying, board, square);
+    buying.currentPlayer = game.currentPlayer;
+    forks[WHATIF_BUYS] = forkGame(&buying, forks[WHATIF_AS_SAVED]);
+    
+    vector<WhatIfWorker> workers(numThreads);
+    for (int i = 0; i < numThreads; i++) {
+        for (int j = 0; j < WHATIF_ALTERNATIVES; j++) {
+            workers[i].forks[j] = forks[j];
+        }
+        workers[i].turns = turns;
+        workers[i].first = branches * i / numThreads;
+        workers[i].end = branches * (i + 1) / numThreads;
+        workers[i].seed = seed;
+        memset(&workers[i].partial, 0, sizeof(WhatIfResult));
+    }
+    
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    vector<thread> threads;
+    for (int i = 0; i < numThreads; i++) {
+        threads.push_back(thread(whatIfWorker, &workers[i]));
+    }
+    for (int i = 0; i < numThreads; i++) {
+        threads[i].join();
+    }
+    
+    WhatIfResult result;
+    memset(&result, 0, sizeof(WhatIfResult));
+    for (int i = 0; i < numThreads; i++) {
+        result.branches += workers[i].partial.branches;
+        for (int j = 0; j < WHATIF_ALTERNATIVES; j++) {
+            for (int k = 0; k < MAX_PLAYERS; k++) {
+                result.netWorth[j][k] += workers[i].partial.netWorth[j][k];
+                result.bankrupt[j][k] += workers[i].partial.bankrupt[j][k];
+            }
+        }
+    }
+    result.threads = numThreads;
+    result.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    for (int j = 0; j < WHATIF_ALTERNATIVES; j++) {
+        result.forkBytes[j] = forkBytes(forks[j]);
+    }
+    
+    cout << "What-if from " << filename << ": " << turns << " turns (seed " << seed << ")\n";
+    displayWhatIfResult(&result, &game, playerNum, square);
+    releaseFork(forks[WHATIF_BUYS]);
+    releaseFork(forks[WHATIF_AS_SAVED]);
+    return 0;
+}
@@ -0,0 +1,29 @@
+#ifndef WHATIF_H
+#define WHATIF_H
+
+#include "simulation.h"
+
+// What-if analysis from a saved game: how the next few turns go as saved
+// and if a player buys a square now, over many branches. Both
+// alternatives are forks of the loaded position (see fork.h), and every
+// branch plays both with the same dice, so the difference between them
+// comes from the purchase, not the rolls. Everyone is played by the
+// basic bot.
+const int WHATIF_AS_SAVED = 0;
+const int WHATIF_BUYS = 1;
+const int WHATIF_ALTERNATIVES = 2;
+const int WHATIF_DEFAULT_TURNS = 20;
+
+struct WhatIfResult {
+    long long branches;
+    long long netWorth[WHATIF_ALTERNATIVES][MAX_PLAYERS]; // summed over branches
+    long long bankrupt[WHATIF_ALTERNATIVES][MAX_PLAYERS]; // branches ending with the player bankrupt
+    int forkBytes[WHATIF_ALTERNATIVES];
+    int threads;
+    double seconds;
+};
+
+// Function declarations
+int runWhatIf(const char*, int, int, int, long long, int, unsigned long long);
+
+#endif